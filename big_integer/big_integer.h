@@ -1,9 +1,27 @@
 #ifndef BIG_INTEGER_BIG_INTEGER_H
 #define BIG_INTEGER_BIG_INTEGER_H
 
+#include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "bits.h"
+#include "division.h"
+#include "limbs.h"
+#include "modular.h"
+#include "multiplication.h"
+#include "number_theory.h"
+#include "radix.h"
+#include "serialization.h"
+#include "thread_pool.h"
 
 class BigIntegerOverflow : public std::runtime_error {
 public:
@@ -17,124 +35,245 @@ public:
     }
 };
 
+class BigIntegerNegativeExponent : public std::runtime_error {
+public:
+    BigIntegerNegativeExponent() : std::runtime_error("BigIntegerNegativeExponent") {
+    }
+};
+
+class BigIntegerNegativeRoot : public std::runtime_error {
+public:
+    BigIntegerNegativeRoot() : std::runtime_error("BigIntegerNegativeRoot") {
+    }
+};
+
+class BigIntegerNotInvertible : public std::runtime_error {
+public:
+    BigIntegerNotInvertible() : std::runtime_error("BigIntegerNotInvertible") {
+    }
+};
+
+class BigIntegerUnsupportedBase : public std::runtime_error {
+public:
+    BigIntegerUnsupportedBase() : std::runtime_error("BigIntegerUnsupportedBase") {
+    }
+};
+
+template <size_t NDigits>
+class ModularContext;
+
+template <size_t NDigits>
+class StaticBigInteger;
+
+// Specialized by the lazy expression types of expression.h, which BigInteger can be assigned from.
+template <class T>
+struct IsBigIntegerExpression : std::false_type {};
+
 template <size_t NDigits = 40000>
 class BigInteger {
 private:
-    static const int kBlockMax = 10000;
-    static const size_t kBlockSize = 4;
-    size_t blocks_ = NDigits / 4 + 1;
-    bool negative_ = false;
-    int number_[NDigits / 4 + 1];
+    using Limb = big_integer_detail::Limb;
+    // 3322 / 1000 > log2(10), so kBlocks binary limbs hold any NDigits-digit decimal number.
+    static constexpr size_t kBlocks = NDigits * 3322 / 1000 / big_integer_detail::kLimbBits + 2;
+    // Values of up to kInlineBlocks limbs live in inline_, longer ones on the heap.
+    static constexpr size_t kInlineBlocks = 2;
+    bool negative_;
     size_t active_blocks_;
+    size_t capacity_;
+    Limb* number_;
+    Limb inline_[kInlineBlocks];
 
-    void Add(const BigInteger<NDigits>& other);
-    void Subtract(const BigInteger<NDigits>& other);
-    void TenTimes();
-    void TenTimes(const size_t repeat);
-    void Multiply(const int digit);
-    void MultiplyByBlock(size_t block);
+    void Add(const Limb* other, size_t other_size);
+    void Subtract(const Limb* other, size_t other_size);
+    void AddSigned(const Limb* other, size_t other_size, bool negative);
+    void AddProduct(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second, bool subtract);
+    void AddProductSmall(const BigInteger<NDigits>& first, Limb factor, bool negative);
+    void AssignMagnitude(uint64_t magnitude, bool negative);
+    void MultiplySmall(int64_t factor);
+    void DivideSmall(int64_t divisor, bool keep_remainder);
+    static int CompareToSmall(const BigInteger<NDigits>& value, int64_t number);
+    void AssignLimbs(const Limb* limbs, size_t size, bool negative);
+    void ApplyBitwise(big_integer_detail::BitwiseOperation operation, const BigInteger<NDigits>& other);
+    void AssignView(const BigIntegerView& view);
+    uint64_t SmallMagnitude() const;
+    static int CompareToView(const BigInteger<NDigits>& value, const BigIntegerView& view);
+    static size_t CheckedDigitBits(unsigned base);
+    static unsigned StreamBase(std::ios_base::fmtflags flags);
+    void Reserve(size_t blocks);
+    void Release();
+    static void CheckCapacity(size_t blocks);
+    static void DivideModulo(const BigInteger<NDigits>& dividend, const BigInteger<NDigits>& divisor,
+                             BigInteger<NDigits>* quotient, BigInteger<NDigits>* remainder);
+    static BigInteger<NDigits> GreatestCommonDivisor(const BigInteger<NDigits>& first,
+                                                     const BigInteger<NDigits>& second,
+                                                     BigInteger<NDigits>* first_factor,
+                                                     BigInteger<NDigits>* second_factor);
+
+    friend class ModularContext<NDigits>;
 
 public:
     BigInteger();
     BigInteger(int num);      //  NOLINT
     BigInteger(int64_t num);  //  NOLINT
     explicit BigInteger(const char* str);
+    explicit BigInteger(const BigIntegerView& view);
+    // Copies the limbs of a compile-time constant of static_big_integer.h.
+    template <size_t NOtherDigits>
+    BigInteger(const StaticBigInteger<NOtherDigits>& value) : BigInteger() {  //  NOLINT
+        AssignLimbs(value.Limbs(), value.LimbCount(), value.IsNegative());
+    }
     BigInteger(const BigInteger<NDigits>& other);
+    BigInteger(BigInteger<NDigits>&& other) noexcept;
+    template <class Expression, class = typename std::enable_if<IsBigIntegerExpression<Expression>::value>::type>
+    BigInteger(const Expression& expression) : BigInteger() {  //  NOLINT
+        expression.EvaluateTo(*this);
+    }
+    ~BigInteger();
     bool IsNegative() const;
     BigInteger<NDigits>& operator=(const BigInteger<NDigits>& other);
+    BigInteger<NDigits>& operator=(BigInteger<NDigits>&& other) noexcept;
+    template <class Expression, class = typename std::enable_if<IsBigIntegerExpression<Expression>::value>::type>
+    BigInteger<NDigits>& operator=(const Expression& expression) {
+        expression.EvaluateTo(*this);
+        return *this;
+    }
+    template <class Expression, class = typename std::enable_if<IsBigIntegerExpression<Expression>::value>::type>
+    BigInteger<NDigits>& operator+=(const Expression& expression) {
+        expression.AccumulateTo(*this, false);
+        return *this;
+    }
+    template <class Expression, class = typename std::enable_if<IsBigIntegerExpression<Expression>::value>::type>
+    BigInteger<NDigits>& operator-=(const Expression& expression) {
+        expression.AccumulateTo(*this, true);
+        return *this;
+    }
     BigInteger<NDigits> operator+() const;
-    BigInteger<NDigits> operator-() const;
+    BigInteger<NDigits> operator-() const&;
+    BigInteger<NDigits> operator-() &&;
     BigInteger<NDigits>& operator+=(const BigInteger<NDigits>& other);
     BigInteger<NDigits>& operator-=(const BigInteger<NDigits>& other);
     BigInteger<NDigits>& operator*=(const BigInteger<NDigits>& other);
+    BigInteger<NDigits>& operator/=(const BigInteger<NDigits>& other);
+    BigInteger<NDigits>& operator%=(const BigInteger<NDigits>& other);
+    // Mixed operands work on the magnitude of number directly, without building a BigInteger for it.
+    BigInteger<NDigits>& operator+=(int64_t number);
+    BigInteger<NDigits>& operator-=(int64_t number);
+    BigInteger<NDigits>& operator*=(int64_t number);
+    BigInteger<NDigits>& operator/=(int64_t number);
+    BigInteger<NDigits>& operator%=(int64_t number);
+    // Shifts by bits: <<= multiplies by 2^bits, >>= divides rounding towards minus infinity like the
+    // arithmetic shift of a two's complement number.
+    BigInteger<NDigits>& operator<<=(size_t bits);
+    BigInteger<NDigits>& operator>>=(size_t bits);
+    // Shifts by decimal digits: multiplies by 10^digits or divides by it rounding towards zero.
+    void ShiftDecimalLeft(size_t digits);
+    void ShiftDecimalRight(size_t digits);
+    // Increments and decrements only touch the limbs the carry or borrow reaches.
     BigInteger<NDigits>& operator++();
     BigInteger<NDigits>& operator--();
     BigInteger<NDigits> operator++(int);
     BigInteger<NDigits> operator--(int);
     explicit operator bool() const;
+    // Bits of the magnitude, 0 for zero.
+    size_t BitLength() const;
+    // Set bits of the magnitude.
+    size_t PopCount() const;
+    // Bit of the infinite two's complement representation, negative values have all high bits set.
+    bool TestBit(size_t bit) const;
+    // Bitwise operations with the semantics of infinite two's complement, so ~x = -x - 1.
+    BigInteger<NDigits> operator~() const;
+    BigInteger<NDigits>& operator&=(const BigInteger<NDigits>& other);
+    BigInteger<NDigits>& operator|=(const BigInteger<NDigits>& other);
+    BigInteger<NDigits>& operator^=(const BigInteger<NDigits>& other);
+    // Reads length characters with an optional leading sign. Bases other than 10 must be powers of two
+    // up to 32 and take digits in either case, without a prefix such as 0x.
+    void FromString(const char* str, size_t length, unsigned base = 10);
+    // Room ToString needs for the current value, the sign included.
+    size_t MaxStringLength(unsigned base = 10) const;
+    // Writes the value without a terminating zero into buffer of at least MaxStringLength(base)
+    // characters, returns the number of characters written. Letter digits are lower case.
+    size_t ToString(char* buffer, unsigned base = 10) const;
+    // The magnitude as ByteLength() raw bytes, the sign is not part of the image.
+    size_t ByteLength() const;
+    void ToBytes(uint8_t* buffer, BigIntegerByteOrder order) const;
+    // Sets the non-negative value of size raw bytes.
+    void FromBytes(const uint8_t* bytes, size_t size, BigIntegerByteOrder order);
+    // Records of the binary wire format of serialization.h. Serialize writes SerializedLength() bytes
+    // and returns their number, Deserialize reads one record from the size bytes at data and returns
+    // its length, throwing BigIntegerInvalidFormat for malformed or truncated input.
+    size_t SerializedLength() const;
+    size_t Serialize(uint8_t* buffer) const;
+    size_t Deserialize(const uint8_t* data, size_t size);
+    // Streams follow the std::hex and std::oct base flags and std::uppercase.
     friend std::istream& operator>>(std::istream& is, BigInteger<NDigits>& big_num) {
-        for (size_t i = 0; i < big_num.blocks_; ++i) {
-            big_num.number_[i] = 0;
-        }
-        const int max_string_size = NDigits;
-        char str[max_string_size];
-        is >> str;
-        if (str[0] == '-') {
-            big_num.negative_ = true;
-        }
-        size_t length = ((str[0] == '-' || str[0] == '+') ? strlen(str) - 1 : strlen(str));
-        if (length > NDigits) {
-            throw BigIntegerOverflow{};
-        }
-        length = ((str[0] == '-' || str[0] == '+') ? length + 1 : length);
-        const char* ptr = &str[length];
-        const char* end = ((str[0] == '-' || str[0] == '+') ? &str[1] : &str[0]);
-        size_t counter = 0;
-        while (ptr > end) {
-            size_t block = 0;
-            size_t koefficient = 1;
-            while (koefficient < big_num.kBlockMax) {
-                if (ptr > end) {
-                    --ptr;
-                    block += int(*ptr - '0') * koefficient;
-                }
-                koefficient *= 10;
-            }
-            big_num.number_[counter] = block;
-            ++counter;
-        }
-        big_num.active_blocks_ = counter;
-        if (counter == 1 && big_num.number_[0] == 0) {
-            big_num.negative_ = false;
-            big_num.active_blocks_ = 0;
+        std::string str;
+        if (is >> str) {
+            big_num.FromString(str.c_str(), str.size(), StreamBase(is.flags()));
         }
         return is;
     }
     friend std::ostream& operator<<(std::ostream& os, const BigInteger<NDigits>& big_num) {
-        if (big_num.IsNegative()) {
-            os << "-";
-        }
-        int ind = big_num.blocks_ - 1;
-        while (big_num.number_[ind] == 0 && ind > 0) {
-            --ind;
-        }
-        os << big_num.number_[ind];
-        --ind;
-        if (ind >= 0) {
-            while (ind >= 0) {
-                size_t koefficient = 10;
-                while (koefficient < big_num.kBlockMax) {
-                    if (big_num.number_[ind] / koefficient == 0) {
-                        os << "0";
-                    }
-                    koefficient *= 10;
-                }
-                os << big_num.number_[ind];
-                --ind;
+        unsigned base = StreamBase(os.flags());
+        std::unique_ptr<char[]> buffer(new char[big_num.MaxStringLength(base)]);
+        size_t length = big_num.ToString(buffer.get(), base);
+        if ((os.flags() & std::ios_base::uppercase) != 0) {
+            for (size_t i = 0; i < length; ++i) {
+                buffer[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(buffer[i])));
             }
         }
-        return os;
+        return os.write(buffer.get(), static_cast<std::streamsize>(length));
     }
-    friend bool AbsLess(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
-        int end = std::max(first.active_blocks_, second.active_blocks_);
-        for (int i = end - 1; i >= 0; --i) {
-            if (first.number_[i] > second.number_[i]) {
-                return false;
-            }
-            if (first.number_[i] < second.number_[i]) {
-                return true;
-            }
+    // Quotient rounded towards zero and the remainder with the sign of the dividend.
+    friend std::pair<BigInteger<NDigits>, BigInteger<NDigits>> DivMod(const BigInteger<NDigits>& dividend,
+                                                                      const BigInteger<NDigits>& divisor) {
+        std::pair<BigInteger<NDigits>, BigInteger<NDigits>> result;
+        DivideModulo(dividend, divisor, &result.first, &result.second);
+        return result;
+    }
+    // acc += first * second and acc -= first * second without a BigInteger temporary for the product.
+    friend void AddMul(BigInteger<NDigits>& acc, const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+        acc.AddProduct(first, second, false);
+    }
+    friend void SubMul(BigInteger<NDigits>& acc, const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+        acc.AddProduct(first, second, true);
+    }
+    // acc += first * factor, in a single pass over the limbs when the signs of acc and first agree.
+    friend void AddMulSmall(BigInteger<NDigits>& acc, const BigInteger<NDigits>& first, uint32_t factor) {
+        acc.AddProductSmall(first, factor, first.negative_);
+    }
+    // floor(sqrt(value)) and value - floor(sqrt(value))^2 for a non-negative value.
+    friend std::pair<BigInteger<NDigits>, BigInteger<NDigits>> ISqrtRem(const BigInteger<NDigits>& value) {
+        if (value.negative_) {
+            throw BigIntegerNegativeRoot{};
         }
-        return false;
+        big_integer_detail::Natural root;
+        big_integer_detail::Natural remainder;
+        big_integer_detail::SqrtRem(root, remainder,
+                                    big_integer_detail::Natural(value.number_, value.number_ + value.active_blocks_));
+        std::pair<BigInteger<NDigits>, BigInteger<NDigits>> result;
+        result.first.AssignLimbs(root.data(), root.size(), false);
+        result.second.AssignLimbs(remainder.data(), remainder.size(), false);
+        return result;
+    }
+    // The non-negative greatest common divisor, Gcd(0, 0) = 0.
+    friend BigInteger<NDigits> Gcd(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+        return GreatestCommonDivisor(first, second, nullptr, nullptr);
+    }
+    // (g, x, y) with g = Gcd(first, second) = first * x + second * y, where 0 <= x < |second| / g unless
+    // second is zero.
+    friend std::tuple<BigInteger<NDigits>, BigInteger<NDigits>, BigInteger<NDigits>> ExtGcd(
+        const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+        std::tuple<BigInteger<NDigits>, BigInteger<NDigits>, BigInteger<NDigits>> result;
+        std::get<0>(result) = GreatestCommonDivisor(first, second, &std::get<1>(result), &std::get<2>(result));
+        return result;
+    }
+    friend bool AbsLess(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+        return big_integer_detail::Compare(first.number_, first.active_blocks_, second.number_,
+                                           second.active_blocks_) < 0;
     }
     friend bool AbsEqual(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
-        int end = std::max(first.active_blocks_, second.active_blocks_);
-        for (int i = end - 1; i >= 0; --i) {
-            if (first.number_[i] != second.number_[i]) {
-                return false;
-            }
-        }
-        return true;
+        return big_integer_detail::Compare(first.number_, first.active_blocks_, second.number_,
+                                           second.active_blocks_) == 0;
     }
     friend bool operator<(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
         if (first.IsNegative() && !second.IsNegative()) {
@@ -154,101 +293,325 @@ public:
         }
         return AbsEqual(first, second);
     }
+    friend bool operator<(const BigInteger<NDigits>& first, int64_t second) {
+        return CompareToSmall(first, second) < 0;
+    }
+    friend bool operator<(int64_t first, const BigInteger<NDigits>& second) {
+        return CompareToSmall(second, first) > 0;
+    }
+    friend bool operator==(const BigInteger<NDigits>& first, int64_t second) {
+        return CompareToSmall(first, second) == 0;
+    }
+    // Comparisons with serialized values, without deserializing them.
+    friend bool operator<(const BigInteger<NDigits>& first, const BigIntegerView& second) {
+        return CompareToView(first, second) < 0;
+    }
+    friend bool operator<(const BigIntegerView& first, const BigInteger<NDigits>& second) {
+        return CompareToView(second, first) > 0;
+    }
+    friend bool operator==(const BigInteger<NDigits>& first, const BigIntegerView& second) {
+        return CompareToView(first, second) == 0;
+    }
+    friend bool operator==(const BigIntegerView& first, const BigInteger<NDigits>& second) {
+        return CompareToView(second, first) == 0;
+    }
 };
 
 template <size_t NDigits>
-BigInteger<NDigits>::BigInteger() : negative_(false), active_blocks_(0) {
-    for (size_t i = 0; i < blocks_; ++i) {
-        this->number_[i] = 0;
+BigInteger<NDigits>::BigInteger()
+    : negative_(false), active_blocks_(0), capacity_(kInlineBlocks), number_(inline_) {
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(int num) : BigInteger() {
+    AssignMagnitude((num < 0) ? -static_cast<uint64_t>(num) : static_cast<uint64_t>(num), num < 0);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(int64_t num) : BigInteger() {
+    AssignMagnitude((num < 0) ? -static_cast<uint64_t>(num) : static_cast<uint64_t>(num), num < 0);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(const char* str) : BigInteger() {
+    FromString(str, strlen(str));
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(const BigIntegerView& view) : BigInteger() {
+    AssignView(view);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(const BigInteger<NDigits>& other) : BigInteger() {
+    Reserve(other.active_blocks_);
+    negative_ = other.negative_;
+    active_blocks_ = other.active_blocks_;
+    big_integer_detail::Copy(number_, other.number_, active_blocks_);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::BigInteger(BigInteger<NDigits>&& other) noexcept : BigInteger() {
+    *this = std::move(other);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::~BigInteger() {
+    Release();
+}
+
+// Makes room for blocks limbs keeping the active ones, the heap buffer at least doubles on every growth.
+template <size_t NDigits>
+void BigInteger<NDigits>::Reserve(size_t blocks) {
+    if (blocks <= capacity_) {
+        return;
+    }
+    CheckCapacity(blocks);
+    size_t capacity = (2 * capacity_ > blocks) ? 2 * capacity_ : blocks;
+    if (capacity > kBlocks) {
+        capacity = kBlocks;
+    }
+    Limb* number = new Limb[capacity];
+    big_integer_detail::Copy(number, number_, active_blocks_);
+    Release();
+    number_ = number;
+    capacity_ = capacity;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::Release() {
+    if (number_ != inline_) {
+        delete[] number_;
+    }
+    number_ = inline_;
+    capacity_ = kInlineBlocks;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::CheckCapacity(size_t blocks) {
+    if (blocks > kBlocks) {
+        throw BigIntegerOverflow{};
+    }
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::AssignMagnitude(uint64_t magnitude, bool negative) {
+    active_blocks_ = 0;
+    while (magnitude != 0) {
+        Reserve(active_blocks_ + 1);
+        number_[active_blocks_] = static_cast<Limb>(magnitude);
+        magnitude >>= big_integer_detail::kLimbBits;
+        ++active_blocks_;
+    }
+    negative_ = negative && active_blocks_ != 0;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::AssignLimbs(const Limb* limbs, size_t size, bool negative) {
+    active_blocks_ = 0;
+    Reserve(size);
+    big_integer_detail::Copy(number_, limbs, size);
+    active_blocks_ = size;
+    negative_ = negative && size != 0;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::CheckedDigitBits(unsigned base) {
+    size_t bits = big_integer_detail::DigitBits(base);
+    if (bits == 0) {
+        throw BigIntegerUnsupportedBase{};
     }
+    return bits;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>::BigInteger(int num) : negative_(false) {
-    for (size_t i = 0; i < blocks_; ++i) {
-        this->number_[i] = 0;
+unsigned BigInteger<NDigits>::StreamBase(std::ios_base::fmtflags flags) {
+    switch (flags & std::ios_base::basefield) {
+        case std::ios_base::hex:
+            return 16;
+        case std::ios_base::oct:
+            return 8;
+        default:
+            return 10;
     }
-    if (num < 0) {
-        this->negative_ = true;
-        num *= -1;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::FromString(const char* str, size_t length, unsigned base) {
+    bool negative = (length > 0 && str[0] == '-');
+    if (length > 0 && (str[0] == '-' || str[0] == '+')) {
+        ++str;
+        --length;
     }
-    size_t counter = 0;
-    while (num != 0) {
-        int block = num % kBlockMax;
-        if (counter >= blocks_) {
-            throw BigIntegerOverflow{};
+    if (base != 10) {
+        // Power of two bases map digits straight to bits, linear in the length.
+        size_t bits = CheckedDigitBits(base);
+        while (length > 0 && str[0] == '0') {
+            ++str;
+            --length;
         }
-        this->number_[counter] = block;
-        num /= kBlockMax;
-        ++counter;
+        active_blocks_ = 0;
+        Reserve((length * bits + big_integer_detail::kLimbBits - 1) / big_integer_detail::kLimbBits);
+        active_blocks_ = big_integer_detail::FromBinaryRadix(number_, str, length, bits);
+        negative_ = negative && active_blocks_ != 0;
+        return;
+    }
+    if (length > NDigits) {
+        throw BigIntegerOverflow{};
+    }
+    active_blocks_ = 0;
+    if (length <= big_integer_detail::kRadixSchoolbookDigits) {
+        // Short inputs are converted chunk by chunk, which never writes past the limbs of the value.
+        size_t blocks = big_integer_detail::LimbsForDigits(length);
+        Reserve((blocks < kBlocks) ? blocks : kBlocks);
+        active_blocks_ = big_integer_detail::FromDecimal(number_, str, length);
+    } else {
+        std::unique_ptr<Limb[]> limbs(new Limb[big_integer_detail::LimbsForDigits(length)]);
+        size_t size = big_integer_detail::FromDecimal(limbs.get(), str, length);
+        Reserve(size);
+        big_integer_detail::Copy(number_, limbs.get(), size);
+        active_blocks_ = size;
+    }
+    negative_ = negative && active_blocks_ != 0;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::MaxStringLength(unsigned base) const {
+    if (base != 10) {
+        return big_integer_detail::BinaryDigits(number_, active_blocks_, CheckedDigitBits(base)) + 1;
     }
-    active_blocks_ = counter;
+    return big_integer_detail::DigitsForLimbs(active_blocks_) + 1;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>::BigInteger(int64_t num) : negative_(false) {
-    for (size_t i = 0; i < blocks_; ++i) {
-        this->number_[i] = 0;
+size_t BigInteger<NDigits>::ToString(char* buffer, unsigned base) const {
+    size_t bits = (base != 10) ? CheckedDigitBits(base) : 0;
+    if (active_blocks_ == 0) {
+        buffer[0] = '0';
+        return 1;
     }
-    if (num < 0) {
-        this->negative_ = true;
-        num *= -1;
+    size_t sign = 0;
+    if (negative_) {
+        buffer[sign++] = '-';
     }
-    size_t counter = 0;
-    while (num != 0) {
-        int block = static_cast<int>(num % kBlockMax);
-        if (counter >= blocks_) {
-            throw BigIntegerOverflow{};
+    if (bits != 0) {
+        size_t digits = big_integer_detail::BinaryDigits(number_, active_blocks_, bits);
+        big_integer_detail::ToBinaryRadix(buffer + sign, digits, number_, active_blocks_, bits);
+        return sign + digits;
+    }
+    size_t digits = big_integer_detail::DigitsForLimbs(active_blocks_);
+    std::unique_ptr<Limb[]> rest(new Limb[active_blocks_]);
+    big_integer_detail::Copy(rest.get(), number_, active_blocks_);
+    big_integer_detail::ToDecimal(buffer + sign, digits, rest.get(), active_blocks_);
+    size_t zeros = 0;
+    while (buffer[sign + zeros] == '0') {
+        ++zeros;
+    }
+    memmove(buffer + sign, buffer + sign + zeros, digits - zeros);
+    return sign + digits - zeros;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::ByteLength() const {
+    return (BitLength() + 7) / 8;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::ToBytes(uint8_t* buffer, BigIntegerByteOrder order) const {
+    big_integer_detail::ToBytes(buffer, ByteLength(), number_, active_blocks_, order);
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::FromBytes(const uint8_t* bytes, size_t size, BigIntegerByteOrder order) {
+    // Leading zero bytes must not count against the capacity.
+    if (order == BigIntegerByteOrder::kLittleEndian) {
+        while (size > 0 && bytes[size - 1] == 0) {
+            --size;
+        }
+    } else {
+        while (size > 0 && bytes[0] == 0) {
+            ++bytes;
+            --size;
         }
-        this->number_[counter] = block;
-        num /= kBlockMax;
-        ++counter;
     }
-    active_blocks_ = counter;
+    active_blocks_ = 0;
+    Reserve((size + 3) / 4);
+    active_blocks_ = big_integer_detail::FromBytes(number_, bytes, size, order);
+    negative_ = false;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>::BigInteger(const char* str) : negative_(false) {
-    for (size_t i = 0; i < blocks_; ++i) {
-        this->number_[i] = 0;
+void BigInteger<NDigits>::AssignView(const BigIntegerView& view) {
+    active_blocks_ = 0;
+    Reserve(view.LimbCount());
+    for (size_t i = 0; i < view.LimbCount(); ++i) {
+        number_[i] = view.LimbAt(i);
     }
-    if (str[0] == '-') {
-        this->negative_ = true;
+    active_blocks_ = view.LimbCount();
+    negative_ = view.IsNegative();
+}
+
+// The magnitude if it fits the varint form of a record, otherwise kVarintMagnitudeLimit.
+template <size_t NDigits>
+uint64_t BigInteger<NDigits>::SmallMagnitude() const {
+    if (active_blocks_ > 2) {
+        return big_integer_detail::kVarintMagnitudeLimit;
     }
-    size_t length = ((str[0] == '-' || str[0] == '+') ? strlen(str) - 1 : strlen(str));
-    if (length > NDigits) {
-        throw BigIntegerOverflow{};
+    uint64_t magnitude = 0;
+    for (size_t i = active_blocks_; i > 0; --i) {
+        magnitude = (magnitude << big_integer_detail::kLimbBits) | number_[i - 1];
     }
-    length = ((str[0] == '-' || str[0] == '+') ? length + 1 : length);
-    const char* ptr = &str[length];
-    const char* end = ((str[0] == '-' || str[0] == '+') ? &str[1] : &str[0]);
-    size_t counter = 0;
-    while (ptr > end) {
-        size_t block = 0;
-        size_t koefficient = 1;
-        while (koefficient < kBlockMax) {
-            if (ptr > end) {
-                --ptr;
-                block += int(*ptr - '0') * koefficient;
-            }
-            koefficient *= 10;
+    return (magnitude < big_integer_detail::kVarintMagnitudeLimit) ? magnitude
+                                                                    : big_integer_detail::kVarintMagnitudeLimit;
+}
+
+template <size_t NDigits>
+int BigInteger<NDigits>::CompareToView(const BigInteger<NDigits>& value, const BigIntegerView& view) {
+    if (value.negative_ != view.IsNegative()) {
+        return value.negative_ ? -1 : 1;
+    }
+    int comparison = 0;
+    if (value.active_blocks_ != view.LimbCount()) {
+        comparison = (value.active_blocks_ < view.LimbCount()) ? -1 : 1;
+    }
+    for (size_t i = value.active_blocks_; comparison == 0 && i > 0; --i) {
+        Limb limb = view.LimbAt(i - 1);
+        if (value.number_[i - 1] != limb) {
+            comparison = (value.number_[i - 1] < limb) ? -1 : 1;
         }
-        number_[counter] = block;
-        ++counter;
     }
-    active_blocks_ = counter;
+    return value.negative_ ? -comparison : comparison;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>::BigInteger(const BigInteger<NDigits>& other) {
-    for (size_t i = 0; i < other.active_blocks_; ++i) {
-        this->number_[i] = other.number_[i];
+size_t BigInteger<NDigits>::SerializedLength() const {
+    uint64_t magnitude = SmallMagnitude();
+    if (magnitude < big_integer_detail::kVarintMagnitudeLimit) {
+        return big_integer_detail::VarintLength(magnitude << 2);
     }
-    for (size_t i = other.active_blocks_; i < blocks_; ++i) {
-        this->number_[i] = 0;
+    return big_integer_detail::VarintLength(static_cast<uint64_t>(active_blocks_) << 2) +
+           active_blocks_ * big_integer_detail::kLimbBytes;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::Serialize(uint8_t* buffer) const {
+    uint64_t sign = negative_ ? 2 : 0;
+    uint64_t magnitude = SmallMagnitude();
+    if (magnitude < big_integer_detail::kVarintMagnitudeLimit) {
+        return big_integer_detail::WriteVarint(buffer, (magnitude << 2) | sign | 1);
     }
-    this->negative_ = other.negative_;
-    this->active_blocks_ = other.active_blocks_;
+    size_t length = big_integer_detail::WriteVarint(buffer, (static_cast<uint64_t>(active_blocks_) << 2) | sign);
+    size_t bytes = active_blocks_ * big_integer_detail::kLimbBytes;
+    big_integer_detail::ToBytes(buffer + length, bytes, number_, active_blocks_, BigIntegerByteOrder::kLittleEndian);
+    return length + bytes;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::Deserialize(const uint8_t* data, size_t size) {
+    BigIntegerView view;
+    size_t length = view.Parse(data, size);
+    AssignView(view);
+    return length;
 }
 
 template <size_t NDigits>
@@ -259,13 +622,33 @@ bool BigInteger<NDigits>::IsNegative() const {
 template <size_t NDigits>
 BigInteger<NDigits>& BigInteger<NDigits>::operator=(const BigInteger<NDigits>& other) {
     if (this != &other) {
+        active_blocks_ = 0;
+        Reserve(other.active_blocks_);
         this->negative_ = other.negative_;
-        size_t end = std::max(this->active_blocks_, other.active_blocks_);
-        for (size_t i = 0; i < end; ++i) {
-            this->number_[i] = other.number_[i];
-        }
         this->active_blocks_ = other.active_blocks_;
+        big_integer_detail::Copy(number_, other.number_, active_blocks_);
+    }
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator=(BigInteger<NDigits>&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    Release();
+    if (other.number_ == other.inline_) {
+        big_integer_detail::Copy(inline_, other.inline_, other.active_blocks_);
+    } else {
+        number_ = other.number_;
+        capacity_ = other.capacity_;
+        other.number_ = other.inline_;
+        other.capacity_ = kInlineBlocks;
     }
+    negative_ = other.negative_;
+    active_blocks_ = other.active_blocks_;
+    other.negative_ = false;
+    other.active_blocks_ = 0;
     return *this;
 }
 
@@ -275,7 +658,7 @@ BigInteger<NDigits> BigInteger<NDigits>::operator+() const {
 }
 
 template <size_t NDigits>
-BigInteger<NDigits> BigInteger<NDigits>::operator-() const {
+BigInteger<NDigits> BigInteger<NDigits>::operator-() const& {
     BigInteger<NDigits> result(*this);
     if (active_blocks_ != 0) {
         result.negative_ = !(this->negative_);
@@ -284,234 +667,552 @@ BigInteger<NDigits> BigInteger<NDigits>::operator-() const {
 }
 
 template <size_t NDigits>
-void BigInteger<NDigits>::Add(const BigInteger<NDigits>& other) {
-    size_t inc = 0;
-    size_t end = std::max(active_blocks_, other.active_blocks_);
-    size_t ind = 0;
-    while (ind < end) {
-        int sum = number_[ind] + other.number_[ind];
-        number_[ind] = (sum + inc) % kBlockMax;
-        inc = (sum + inc) / kBlockMax;
-        ++ind;
+BigInteger<NDigits> BigInteger<NDigits>::operator-() && {
+    if (active_blocks_ != 0) {
+        negative_ = !(negative_);
     }
-    active_blocks_ = ind;
-    if (inc != 0) {
-        if (ind < blocks_) {
-            number_[ind] = inc;
-            active_blocks_ = ind + 1;
-        } else {
-            throw BigIntegerOverflow{};
+    return std::move(*this);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator<<=(size_t bits) {
+    if (active_blocks_ == 0) {
+        return *this;
+    }
+    size_t words = bits / big_integer_detail::kLimbBits;
+    size_t shift = bits % big_integer_detail::kLimbBits;
+    Limb out = (shift == 0) ? 0 : number_[active_blocks_ - 1] >> (big_integer_detail::kLimbBits - shift);
+    size_t size = active_blocks_ + words + ((out != 0) ? 1 : 0);
+    Reserve(size);
+    // Going from the top limb down, the destination never overwrites limbs that are still to be read.
+    if (shift == 0) {
+        for (size_t i = active_blocks_; i > 0 && words != 0; --i) {
+            number_[i - 1 + words] = number_[i - 1];
         }
+    } else {
+        big_integer_detail::ShiftLeft(number_ + words, number_, active_blocks_, shift);
     }
+    big_integer_detail::Zero(number_, words);
+    if (out != 0) {
+        number_[size - 1] = out;
+    }
+    active_blocks_ = size;
+    return *this;
 }
 
 template <size_t NDigits>
-void BigInteger<NDigits>::Subtract(const BigInteger<NDigits>& other) {
-    if (AbsEqual(*this, other)) {
-        *this = BigInteger();
+BigInteger<NDigits>& BigInteger<NDigits>::operator>>=(size_t bits) {
+    size_t words = bits / big_integer_detail::kLimbBits;
+    size_t shift = bits % big_integer_detail::kLimbBits;
+    bool inexact = big_integer_detail::Normalize(number_, (words < active_blocks_) ? words : active_blocks_) != 0;
+    if (words >= active_blocks_) {
+        active_blocks_ = 0;
     } else {
-        size_t end = std::max(active_blocks_, other.active_blocks_);
-        size_t ind = 0;
-        if (!AbsLess(*this, other)) {
-            active_blocks_ = 0;
-            while (ind < end) {
-                if (number_[ind] < other.number_[ind]) {
-                    number_[ind] += kBlockMax;
-                    number_[ind + 1] -= 1;
-                }
-                number_[ind] -= other.number_[ind];
-                if (number_[ind] != 0) {
-                    ++active_blocks_;
-                }
-                ++ind;
-            }
+        inexact = big_integer_detail::ShiftRight(number_, number_ + words, active_blocks_ - words, shift) != 0 ||
+                  inexact;
+        active_blocks_ = big_integer_detail::Normalize(number_, active_blocks_ - words);
+    }
+    if (negative_ && inexact) {
+        Limb one = 1;
+        Add(&one, 1);
+    }
+    negative_ = negative_ && active_blocks_ != 0;
+    return *this;
+}
 
-        } else {
-            active_blocks_ = 0;
-            while (ind < end) {
-                if (other.number_[ind] < number_[ind]) {
-                    number_[ind] -= kBlockMax;
-                    number_[ind + 1] += 1;
-                }
-                number_[ind] = other.number_[ind] - number_[ind];
-                if (number_[ind] != 0) {
-                    ++active_blocks_;
-                }
-                ++ind;
+template <size_t NDigits>
+void BigInteger<NDigits>::ShiftDecimalLeft(size_t digits) {
+    if (active_blocks_ == 0 || digits == 0) {
+        return;
+    }
+    if (digits <= big_integer_detail::kRadixSchoolbookDigits) {
+        while (digits > 0) {
+            size_t chunk = (digits < big_integer_detail::kDecimalBaseDigits) ? digits
+                                                                               : big_integer_detail::kDecimalBaseDigits;
+            digits -= chunk;
+            Limb factor = 1;
+            for (size_t i = 0; i < chunk; ++i) {
+                factor *= 10;
+            }
+            Limb carry = big_integer_detail::Mul1(number_, number_, active_blocks_, factor);
+            if (carry != 0) {
+                Reserve(active_blocks_ + 1);
+                number_[active_blocks_++] = carry;
             }
-            negative_ = !(negative_);
         }
+        return;
     }
+    std::unique_ptr<Limb[]> power(new Limb[big_integer_detail::LimbsForDigits(digits + 1)]);
+    size_t power_size = big_integer_detail::PowerOfTen(power.get(), digits);
+    size_t size = active_blocks_ + power_size;
+    std::unique_ptr<Limb[]> product(new Limb[size]);
+    big_integer_detail::Mul(product.get(), number_, active_blocks_, power.get(), power_size);
+    size = big_integer_detail::Normalize(product.get(), size);
+    active_blocks_ = 0;
+    Reserve(size);
+    big_integer_detail::Copy(number_, product.get(), size);
+    active_blocks_ = size;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>& BigInteger<NDigits>::operator+=(const BigInteger<NDigits>& other) {
-    if (this == &other) {
-        Multiply(2);
+void BigInteger<NDigits>::ShiftDecimalRight(size_t digits) {
+    if (active_blocks_ == 0 || digits == 0) {
+        return;
+    }
+    if (digits <= big_integer_detail::kRadixSchoolbookDigits) {
+        while (digits > 0 && active_blocks_ != 0) {
+            size_t chunk = (digits < big_integer_detail::kDecimalBaseDigits) ? digits
+                                                                               : big_integer_detail::kDecimalBaseDigits;
+            digits -= chunk;
+            Limb divisor = 1;
+            for (size_t i = 0; i < chunk; ++i) {
+                divisor *= 10;
+            }
+            big_integer_detail::DivMod1(number_, number_, active_blocks_, divisor);
+            active_blocks_ = big_integer_detail::Normalize(number_, active_blocks_);
+        }
     } else {
-        if (negative_ == other.negative_) {
-            Add(other);
+        std::unique_ptr<Limb[]> power(new Limb[big_integer_detail::LimbsForDigits(digits + 1)]);
+        size_t power_size = big_integer_detail::PowerOfTen(power.get(), digits);
+        if (power_size > active_blocks_) {
+            active_blocks_ = 0;
         } else {
-            Subtract(other);
+            size_t quotient_size = active_blocks_ - power_size + 1;
+            std::unique_ptr<Limb[]> buffer(new Limb[quotient_size + power_size]);
+            big_integer_detail::DivMod(buffer.get(), buffer.get() + quotient_size, number_, active_blocks_,
+                                       power.get(), power_size);
+            active_blocks_ = big_integer_detail::Normalize(buffer.get(), quotient_size);
+            big_integer_detail::Copy(number_, buffer.get(), active_blocks_);
         }
     }
-    return *this;
+    negative_ = negative_ && active_blocks_ != 0;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>& BigInteger<NDigits>::operator-=(const BigInteger<NDigits>& other) {
-    if (this == &other) {
+void BigInteger<NDigits>::Add(const Limb* other, size_t other_size) {
+    size_t size = (active_blocks_ >= other_size) ? active_blocks_ : other_size;
+    Reserve(size);
+    Limb carry = (active_blocks_ >= other_size)
+                     ? big_integer_detail::Add(number_, number_, active_blocks_, other, other_size)
+                     : big_integer_detail::Add(number_, other, other_size, number_, active_blocks_);
+    active_blocks_ = size;
+    if (carry != 0) {
+        Reserve(size + 1);
+        number_[size] = carry;
+        active_blocks_ = size + 1;
+    }
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::Subtract(const Limb* other, size_t other_size) {
+    int comparison = big_integer_detail::Compare(number_, active_blocks_, other, other_size);
+    if (comparison == 0) {
         negative_ = false;
-        for (size_t i = 0; i < active_blocks_; ++i) {
-            number_[i] = 0;
-        }
         active_blocks_ = 0;
+    } else if (comparison > 0) {
+        big_integer_detail::Sub(number_, number_, active_blocks_, other, other_size);
+        active_blocks_ = big_integer_detail::Normalize(number_, active_blocks_);
     } else {
-        if (negative_ == other.negative_) {
-            Subtract(other);
-        } else {
-            Add(other);
-        }
+        Reserve(other_size);
+        big_integer_detail::Sub(number_, other, other_size, number_, active_blocks_);
+        active_blocks_ = big_integer_detail::Normalize(number_, other_size);
+        negative_ = !(negative_);
     }
-    return *this;
 }
 
+// *this += other where other is a magnitude of other_size limbs with the given sign.
 template <size_t NDigits>
-BigInteger<NDigits>& BigInteger<NDigits>::operator*=(const BigInteger<NDigits>& other) {
-    BigInteger<NDigits> result;
-    for (size_t i = 0; i < other.active_blocks_; ++i) {
-        BigInteger<NDigits> summand(*this);
-        summand.MultiplyByBlock(other.number_[i]);
-        summand.TenTimes(i * 4);
-        if (summand.IsNegative()) {
-            summand.negative_ = false;
-        }
-        result += summand;
+void BigInteger<NDigits>::AddSigned(const Limb* other, size_t other_size, bool negative) {
+    if (other_size == 0) {
+        return;
     }
-    if (this->negative_ != other.negative_ && result.active_blocks_ != 0) {
-        result.negative_ = true;
+    if (active_blocks_ == 0) {
+        negative_ = negative;
     }
-    *this = result;
+    if (negative_ == negative) {
+        Add(other, other_size);
+    } else {
+        Subtract(other, other_size);
+    }
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator+=(const BigInteger<NDigits>& other) {
+    AddSigned(other.number_, other.active_blocks_, other.negative_);
     return *this;
 }
 
 template <size_t NDigits>
-void BigInteger<NDigits>::TenTimes() {
-    size_t ind = 0;
-    if (active_blocks_ == 0) {
+BigInteger<NDigits>& BigInteger<NDigits>::operator-=(const BigInteger<NDigits>& other) {
+    AddSigned(other.number_, other.active_blocks_, !other.negative_);
+    return *this;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::AddProduct(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second,
+                                     bool subtract) {
+    if (first.active_blocks_ == 0 || second.active_blocks_ == 0) {
         return;
     }
-    while (ind < active_blocks_ && number_[ind] == 0) {
-        ++ind;
-    }
-    size_t inc = number_[ind] / (kBlockMax / 10);
-    number_[ind] = (number_[ind] * 10) % kBlockMax;
-    ++ind;
-    while (ind < active_blocks_) {
-        number_[ind] = number_[ind] * 10 + inc;
-        if (number_[ind] > (kBlockMax - 1)) {
-            inc = number_[ind] / kBlockMax;
-            number_[ind] %= kBlockMax;
-        } else {
-            inc = 0;
-        }
-        ++ind;
-    }
-    if (inc != 0) {
-        if (ind < blocks_) {
-            ++active_blocks_;
-            number_[ind] = inc;
-        } else {
-            throw BigIntegerOverflow{};
-        }
+    bool negative = (first.negative_ != second.negative_) != subtract;
+    if (second.active_blocks_ == 1) {
+        AddProductSmall(first, second.number_[0], negative);
+        return;
     }
+    size_t size = first.active_blocks_ + second.active_blocks_;
+    big_integer_detail::ScratchLimbs scratch(
+        size + big_integer_detail::MulScratchSize(first.active_blocks_, second.active_blocks_));
+    Limb* product = scratch.Get();
+    big_integer_detail::Mul(product, first.number_, first.active_blocks_, second.number_, second.active_blocks_,
+                            product + size);
+    AddSigned(product, big_integer_detail::Normalize(product, size), negative);
 }
 
 template <size_t NDigits>
-void BigInteger<NDigits>::TenTimes(const size_t repeat) {
-    if (repeat != 0) {
-        for (size_t i = 0; i < repeat; ++i) {
-            this->TenTimes();
-        }
+void BigInteger<NDigits>::AddProductSmall(const BigInteger<NDigits>& first, Limb factor, bool negative) {
+    if (first.active_blocks_ == 0 || factor == 0) {
+        return;
+    }
+    if (active_blocks_ != 0 && negative_ != negative) {
+        big_integer_detail::ScratchLimbs scratch(first.active_blocks_ + 1);
+        Limb* product = scratch.Get();
+        product[first.active_blocks_] = big_integer_detail::Mul1(product, first.number_, first.active_blocks_, factor);
+        AddSigned(product, big_integer_detail::Normalize(product, first.active_blocks_ + 1), negative);
+        return;
+    }
+    negative_ = negative;
+    size_t first_size = first.active_blocks_;
+    size_t size = (active_blocks_ >= first_size) ? active_blocks_ : first_size;
+    Reserve(size);
+    big_integer_detail::Zero(number_ + active_blocks_, size - active_blocks_);
+    Limb carry = big_integer_detail::AddMul1(number_, first.number_, first_size, factor);
+    carry = big_integer_detail::AddCarry(number_ + first_size, number_ + first_size, size - first_size, carry);
+    active_blocks_ = size;
+    if (carry != 0) {
+        Reserve(size + 1);
+        number_[size] = carry;
+        active_blocks_ = size + 1;
     }
 }
 
 template <size_t NDigits>
-void BigInteger<NDigits>::Multiply(const int digit) {
-    if (digit == 0) {
-        for (size_t i = 0; i < active_blocks_; ++i) {
-            number_[i] = 0;
-        }
-        active_blocks_ = 0;
+BigInteger<NDigits>& BigInteger<NDigits>::operator*=(const BigInteger<NDigits>& other) {
+    if (active_blocks_ == 0 || other.active_blocks_ == 0) {
         negative_ = false;
-    } else {
-        size_t inc = 0;
-        size_t ind = 0;
-        while (ind < active_blocks_) {
-            int product = number_[ind] * digit;
-            number_[ind] = (product + inc) % kBlockMax;
-            inc = (product + inc) / kBlockMax;
-            ++ind;
+        active_blocks_ = 0;
+        return *this;
+    }
+    size_t size = active_blocks_ + other.active_blocks_;
+    big_integer_detail::ScratchLimbs scratch(
+        size + big_integer_detail::MulScratchSize(active_blocks_, other.active_blocks_));
+    Limb* product = scratch.Get();
+    big_integer_detail::Mul(product, number_, active_blocks_, other.number_, other.active_blocks_, product + size);
+    size = big_integer_detail::Normalize(product, size);
+    active_blocks_ = 0;
+    Reserve(size);
+    big_integer_detail::Copy(number_, product, size);
+    active_blocks_ = size;
+    negative_ = (negative_ != other.negative_);
+    return *this;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::DivideModulo(const BigInteger<NDigits>& dividend, const BigInteger<NDigits>& divisor,
+                                       BigInteger<NDigits>* quotient, BigInteger<NDigits>* remainder) {
+    if (divisor.active_blocks_ == 0) {
+        throw BigIntegerDivisionByZero{};
+    }
+    if (AbsLess(dividend, divisor)) {
+        if (remainder != nullptr) {
+            *remainder = dividend;
         }
-        active_blocks_ = ind;
-        if (inc != 0) {
-            if (ind < blocks_) {
-                number_[ind] = inc;
-                active_blocks_ = ind;
-            } else {
-                throw BigIntegerOverflow{};
-            }
+        if (quotient != nullptr) {
+            quotient->negative_ = false;
+            quotient->active_blocks_ = 0;
         }
+        return;
+    }
+    bool quotient_negative = (dividend.negative_ != divisor.negative_);
+    bool remainder_negative = dividend.negative_;
+    size_t quotient_size = dividend.active_blocks_ - divisor.active_blocks_ + 1;
+    size_t remainder_size = divisor.active_blocks_;
+    std::unique_ptr<Limb[]> buffer(new Limb[quotient_size + remainder_size]);
+    Limb* quotient_limbs = buffer.get();
+    Limb* remainder_limbs = quotient_limbs + quotient_size;
+    big_integer_detail::DivMod(quotient_limbs, remainder_limbs, dividend.number_, dividend.active_blocks_,
+                               divisor.number_, divisor.active_blocks_);
+    if (quotient != nullptr) {
+        quotient->active_blocks_ = 0;
+        quotient->Reserve(quotient_size);
+        quotient->active_blocks_ = big_integer_detail::Normalize(quotient_limbs, quotient_size);
+        big_integer_detail::Copy(quotient->number_, quotient_limbs, quotient->active_blocks_);
+        quotient->negative_ = quotient_negative && quotient->active_blocks_ != 0;
+    }
+    if (remainder != nullptr) {
+        remainder->active_blocks_ = 0;
+        remainder->Reserve(remainder_size);
+        remainder->active_blocks_ = big_integer_detail::Normalize(remainder_limbs, remainder_size);
+        big_integer_detail::Copy(remainder->number_, remainder_limbs, remainder->active_blocks_);
+        remainder->negative_ = remainder_negative && remainder->active_blocks_ != 0;
     }
 }
 
+// Euclid's algorithm on the magnitudes, see ReduceToGcd. The cofactors come from the reduction matrix
+// and are brought into range by one more division.
 template <size_t NDigits>
-void BigInteger<NDigits>::MultiplyByBlock(size_t block) {
-    size_t digits[kBlockSize];
-    for (size_t i = 0; i < kBlockSize; ++i) {
-        digits[i] = block % 10;
-        block /= 10;
+BigInteger<NDigits> BigInteger<NDigits>::GreatestCommonDivisor(const BigInteger<NDigits>& first,
+                                                               const BigInteger<NDigits>& second,
+                                                               BigInteger<NDigits>* first_factor,
+                                                               BigInteger<NDigits>* second_factor) {
+    using big_integer_detail::Natural;
+    Natural a(first.number_, first.number_ + first.active_blocks_);
+    Natural b(second.number_, second.number_ + second.active_blocks_);
+    BigInteger<NDigits> gcd;
+    if (first_factor == nullptr) {
+        big_integer_detail::ReduceToGcd(a, b, nullptr);
+        const Natural& result = a.empty() ? b : a;
+        gcd.AssignLimbs(result.data(), result.size(), false);
+        return gcd;
     }
-    BigInteger<NDigits> result;
-    for (size_t i = 0; i < kBlockSize; ++i) {
-        BigInteger<NDigits> summand(*this);
-        summand.Multiply(digits[i]);
-        summand.TenTimes(i);
-        result += summand;
+    big_integer_detail::GcdMatrix matrix;
+    big_integer_detail::ReduceToGcd(a, b, &matrix);
+    // The final pair is M^-1 (|first|, |second|) with M^-1 = [[m11, -m01], [-m10, m00]].
+    bool first_in_a = b.empty();
+    const Natural& result = first_in_a ? a : b;
+    const Natural& x = first_in_a ? matrix.m11 : matrix.m10;
+    const Natural& y = first_in_a ? matrix.m01 : matrix.m00;
+    gcd.AssignLimbs(result.data(), result.size(), false);
+    first_factor->AssignLimbs(x.data(), x.size(), first.negative_ == first_in_a);
+    second_factor->AssignLimbs(y.data(), y.size(), second.negative_ != first_in_a);
+    if (second.active_blocks_ != 0) {
+        BigInteger<NDigits> period = second / gcd;
+        period.negative_ = false;
+        *first_factor %= period;
+        if (first_factor->negative_) {
+            *first_factor += period;
+        }
+        BigInteger<NDigits> rest = gcd;
+        SubMul(rest, first, *first_factor);
+        *second_factor = rest / second;
     }
-    *this = result;
+    return gcd;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>& BigInteger<NDigits>::operator++() {
-    *this += 1;
+BigInteger<NDigits>& BigInteger<NDigits>::operator/=(const BigInteger<NDigits>& other) {
+    DivideModulo(*this, other, this, nullptr);
     return *this;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>& BigInteger<NDigits>::operator--() {
-    *this -= 1;
+BigInteger<NDigits>& BigInteger<NDigits>::operator%=(const BigInteger<NDigits>& other) {
+    DivideModulo(*this, other, nullptr, this);
     return *this;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits> BigInteger<NDigits>::operator++(int) {
-    BigInteger<NDigits> old_value(*this);
-    *this += 1;
-    return old_value;
+BigInteger<NDigits>& BigInteger<NDigits>::operator+=(int64_t number) {
+    uint64_t magnitude = (number < 0) ? -static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+    const Limb limbs[2] = {static_cast<Limb>(magnitude), static_cast<Limb>(magnitude >> big_integer_detail::kLimbBits)};
+    AddSigned(limbs, big_integer_detail::Normalize(limbs, 2), number < 0);
+    return *this;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits> BigInteger<NDigits>::operator--(int) {
-    BigInteger<NDigits> old_value(*this);
-    *this -= 1;
-    return old_value;
+BigInteger<NDigits>& BigInteger<NDigits>::operator-=(int64_t number) {
+    uint64_t magnitude = (number < 0) ? -static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+    const Limb limbs[2] = {static_cast<Limb>(magnitude), static_cast<Limb>(magnitude >> big_integer_detail::kLimbBits)};
+    AddSigned(limbs, big_integer_detail::Normalize(limbs, 2), number > 0);
+    return *this;
 }
 
 template <size_t NDigits>
-BigInteger<NDigits>::operator bool() const {
-    BigInteger<NDigits> null;
-    return !(*this == null);
+BigInteger<NDigits>& BigInteger<NDigits>::operator*=(int64_t number) {
+    MultiplySmall(number);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator/=(int64_t number) {
+    DivideSmall(number, false);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator%=(int64_t number) {
+    DivideSmall(number, true);
+    return *this;
+}
+
+// Factors that fit a limb multiply in place, wider ones take the general path.
+template <size_t NDigits>
+void BigInteger<NDigits>::MultiplySmall(int64_t factor) {
+    uint64_t magnitude = (factor < 0) ? -static_cast<uint64_t>(factor) : static_cast<uint64_t>(factor);
+    if ((magnitude >> big_integer_detail::kLimbBits) != 0) {
+        *this *= BigInteger<NDigits>(factor);
+        return;
+    }
+    if (active_blocks_ == 0 || magnitude == 0) {
+        active_blocks_ = 0;
+        negative_ = false;
+        return;
+    }
+    Limb carry = big_integer_detail::Mul1(number_, number_, active_blocks_, static_cast<Limb>(magnitude));
+    if (carry != 0) {
+        Reserve(active_blocks_ + 1);
+        number_[active_blocks_++] = carry;
+    }
+    negative_ = negative_ != (factor < 0);
+}
+
+// Rounds towards zero and leaves the quotient, or the remainder with the sign of the dividend if
+// keep_remainder is set.
+template <size_t NDigits>
+void BigInteger<NDigits>::DivideSmall(int64_t divisor, bool keep_remainder) {
+    uint64_t magnitude = (divisor < 0) ? -static_cast<uint64_t>(divisor) : static_cast<uint64_t>(divisor);
+    if ((magnitude >> big_integer_detail::kLimbBits) != 0) {
+        DivideModulo(*this, BigInteger<NDigits>(divisor), keep_remainder ? nullptr : this,
+                     keep_remainder ? this : nullptr);
+        return;
+    }
+    if (magnitude == 0) {
+        throw BigIntegerDivisionByZero{};
+    }
+    Limb limb_divisor = static_cast<Limb>(magnitude);
+    if (keep_remainder) {
+        AssignMagnitude(big_integer_detail::Mod1(number_, active_blocks_, limb_divisor), negative_);
+        return;
+    }
+    big_integer_detail::DivMod1(number_, number_, active_blocks_, limb_divisor);
+    active_blocks_ = big_integer_detail::Normalize(number_, active_blocks_);
+    negative_ = active_blocks_ != 0 && negative_ != (divisor < 0);
+}
+
+template <size_t NDigits>
+int BigInteger<NDigits>::CompareToSmall(const BigInteger<NDigits>& value, int64_t number) {
+    if (value.negative_ != (number < 0)) {
+        return value.negative_ ? -1 : 1;
+    }
+    uint64_t magnitude = (number < 0) ? -static_cast<uint64_t>(number) : static_cast<uint64_t>(number);
+    const Limb limbs[2] = {static_cast<Limb>(magnitude), static_cast<Limb>(magnitude >> big_integer_detail::kLimbBits)};
+    size_t size = big_integer_detail::Normalize(limbs, 2);
+    int comparison = big_integer_detail::Compare(value.number_, value.active_blocks_, limbs, size);
+    return value.negative_ ? -comparison : comparison;
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::BitLength() const {
+    return big_integer_detail::BitLength(number_, active_blocks_);
+}
+
+template <size_t NDigits>
+size_t BigInteger<NDigits>::PopCount() const {
+    size_t count = 0;
+    for (size_t i = 0; i < active_blocks_; ++i) {
+        count += big_integer_detail::PopCount(number_[i]);
+    }
+    return count;
+}
+
+template <size_t NDigits>
+bool BigInteger<NDigits>::TestBit(size_t bit) const {
+    size_t limb = bit / big_integer_detail::kLimbBits;
+    bool magnitude_bit = limb < active_blocks_ && ((number_[limb] >> (bit % big_integer_detail::kLimbBits)) & 1) != 0;
+    if (!negative_) {
+        return magnitude_bit;
+    }
+    // -m = ~(m - 1), and m - 1 differs from m in the bits up to the lowest set one.
+    size_t lowest = 0;
+    while (number_[lowest] == 0) {
+        ++lowest;
+    }
+    Limb value = number_[lowest];
+    lowest *= big_integer_detail::kLimbBits;
+    for (; (value & 1) == 0; value >>= 1) {
+        ++lowest;
+    }
+    return magnitude_bit != (bit > lowest);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> BigInteger<NDigits>::operator~() const {
+    BigInteger<NDigits> result(*this);
+    if (negative_) {
+        result.negative_ = false;
+        result -= 1;
+    } else {
+        result += 1;
+        result.negative_ = true;
+    }
+    return result;
+}
+
+template <size_t NDigits>
+void BigInteger<NDigits>::ApplyBitwise(big_integer_detail::BitwiseOperation operation,
+                                       const BigInteger<NDigits>& other) {
+    size_t size = ((active_blocks_ > other.active_blocks_) ? active_blocks_ : other.active_blocks_) + 1;
+    if (size <= capacity_) {
+        bool negative = big_integer_detail::Bitwise(operation, number_, number_, active_blocks_, negative_,
+                                                    other.number_, other.active_blocks_, other.negative_);
+        active_blocks_ = big_integer_detail::Normalize(number_, size);
+        negative_ = negative && active_blocks_ != 0;
+        return;
+    }
+    std::unique_ptr<Limb[]> result(new Limb[size]);
+    bool negative = big_integer_detail::Bitwise(operation, result.get(), number_, active_blocks_, negative_,
+                                                other.number_, other.active_blocks_, other.negative_);
+    AssignLimbs(result.get(), big_integer_detail::Normalize(result.get(), size), negative);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator&=(const BigInteger<NDigits>& other) {
+    ApplyBitwise(big_integer_detail::BitwiseOperation::kAnd, other);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator|=(const BigInteger<NDigits>& other) {
+    ApplyBitwise(big_integer_detail::BitwiseOperation::kOr, other);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator^=(const BigInteger<NDigits>& other) {
+    ApplyBitwise(big_integer_detail::BitwiseOperation::kXor, other);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator++() {
+    const Limb kOne[1] = {1};
+    AddSigned(kOne, 1, false);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>& BigInteger<NDigits>::operator--() {
+    const Limb kOne[1] = {1};
+    AddSigned(kOne, 1, true);
+    return *this;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> BigInteger<NDigits>::operator++(int) {
+    BigInteger<NDigits> old_value(*this);
+    ++*this;
+    return old_value;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> BigInteger<NDigits>::operator--(int) {
+    BigInteger<NDigits> old_value(*this);
+    --*this;
+    return old_value;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits>::operator bool() const {
+    return active_blocks_ != 0;
 }
 
 template <size_t NDigits>
@@ -535,6 +1236,184 @@ BigInteger<NDigits> operator*(const BigInteger<NDigits>& first, const BigInteger
     return result;
 }
 
+template <size_t NDigits>
+BigInteger<NDigits> operator/(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+    BigInteger<NDigits> result(first);
+    result /= second;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator%(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+    BigInteger<NDigits> result(first);
+    result %= second;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator<<(const BigInteger<NDigits>& first, size_t bits) {
+    BigInteger<NDigits> result(first);
+    result <<= bits;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator>>(const BigInteger<NDigits>& first, size_t bits) {
+    BigInteger<NDigits> result(first);
+    result >>= bits;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator&(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+    BigInteger<NDigits> result(first);
+    result &= second;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator|(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+    BigInteger<NDigits> result(first);
+    result |= second;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator^(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
+    BigInteger<NDigits> result(first);
+    result ^= second;
+    return result;
+}
+
+// Overloads for temporaries reuse the storage of an rvalue operand instead of copying.
+template <size_t NDigits>
+BigInteger<NDigits> operator+(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first += second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator+(const BigInteger<NDigits>& first, BigInteger<NDigits>&& second) {
+    second += first;
+    return std::move(second);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator+(BigInteger<NDigits>&& first, BigInteger<NDigits>&& second) {
+    first += second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator-(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first -= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator-(const BigInteger<NDigits>& first, BigInteger<NDigits>&& second) {
+    BigInteger<NDigits> result(-std::move(second));
+    result += first;
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator-(BigInteger<NDigits>&& first, BigInteger<NDigits>&& second) {
+    first -= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator*(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first *= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator*(const BigInteger<NDigits>& first, BigInteger<NDigits>&& second) {
+    second *= first;
+    return std::move(second);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator*(BigInteger<NDigits>&& first, BigInteger<NDigits>&& second) {
+    first *= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator/(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first /= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator%(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first %= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator&(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first &= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator|(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first |= second;
+    return std::move(first);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator^(BigInteger<NDigits>&& first, const BigInteger<NDigits>& second) {
+    first ^= second;
+    return std::move(first);
+}
+
+// Mixed int64_t operands take the BigInteger by value and update it with the small compound operators.
+template <size_t NDigits>
+BigInteger<NDigits> operator+(BigInteger<NDigits> first, int64_t second) {
+    first += second;
+    return first;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator+(int64_t first, BigInteger<NDigits> second) {
+    second += first;
+    return second;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator-(BigInteger<NDigits> first, int64_t second) {
+    first -= second;
+    return first;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator*(BigInteger<NDigits> first, int64_t second) {
+    first *= second;
+    return first;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator*(int64_t first, BigInteger<NDigits> second) {
+    second *= first;
+    return second;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator/(BigInteger<NDigits> first, int64_t second) {
+    first /= second;
+    return first;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> operator%(BigInteger<NDigits> first, int64_t second) {
+    first %= second;
+    return first;
+}
+
 template <size_t NDigits>
 bool operator>(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) {
     return (second < first);
@@ -555,4 +1434,194 @@ bool operator!=(const BigInteger<NDigits>& first, const BigInteger<NDigits>& sec
     return !(first == second);
 }
 
+template <size_t NDigits>
+bool operator>(const BigInteger<NDigits>& first, int64_t second) {
+    return (second < first);
+}
+
+template <size_t NDigits>
+bool operator<=(const BigInteger<NDigits>& first, int64_t second) {
+    return !(second < first);
+}
+
+template <size_t NDigits>
+bool operator>=(const BigInteger<NDigits>& first, int64_t second) {
+    return !(first < second);
+}
+
+template <size_t NDigits>
+bool operator!=(const BigInteger<NDigits>& first, int64_t second) {
+    return !(first == second);
+}
+
+template <size_t NDigits>
+bool operator>(int64_t first, const BigInteger<NDigits>& second) {
+    return (second < first);
+}
+
+template <size_t NDigits>
+bool operator<=(int64_t first, const BigInteger<NDigits>& second) {
+    return !(second < first);
+}
+
+template <size_t NDigits>
+bool operator>=(int64_t first, const BigInteger<NDigits>& second) {
+    return !(first < second);
+}
+
+template <size_t NDigits>
+bool operator!=(int64_t first, const BigInteger<NDigits>& second) {
+    return !(first == second);
+}
+
+template <size_t NDigits>
+bool operator==(int64_t first, const BigInteger<NDigits>& second) {
+    return second == first;
+}
+
+// Arithmetic modulo a fixed modulus, set up once and reused for many operations: Montgomery
+// multiplication for odd moduli, Barrett reduction for even ones. Results lie in [0, |modulus|).
+template <size_t NDigits = 40000>
+class ModularContext {
+private:
+    using Limb = big_integer_detail::Limb;
+    BigInteger<NDigits> modulus_;
+    big_integer_detail::ModularArithmetic arithmetic_;
+
+    static BigInteger<NDigits> Magnitude(const BigInteger<NDigits>& modulus);
+    void ToResidue(Limb* residue, const BigInteger<NDigits>& value) const;
+    BigInteger<NDigits> FromResidue(const Limb* residue) const;
+
+public:
+    explicit ModularContext(const BigInteger<NDigits>& modulus);
+    const BigInteger<NDigits>& Modulus() const;
+    BigInteger<NDigits> Reduce(const BigInteger<NDigits>& value) const;
+    BigInteger<NDigits> Multiply(const BigInteger<NDigits>& first, const BigInteger<NDigits>& second) const;
+    BigInteger<NDigits> Pow(const BigInteger<NDigits>& base, const BigInteger<NDigits>& exponent) const;
+};
+
+template <size_t NDigits>
+ModularContext<NDigits>::ModularContext(const BigInteger<NDigits>& modulus)
+    : modulus_(Magnitude(modulus)), arithmetic_(modulus_.number_, modulus_.active_blocks_) {
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> ModularContext<NDigits>::Magnitude(const BigInteger<NDigits>& modulus) {
+    if (!modulus) {
+        throw BigIntegerDivisionByZero{};
+    }
+    BigInteger<NDigits> magnitude(modulus);
+    magnitude.negative_ = false;
+    return magnitude;
+}
+
+template <size_t NDigits>
+void ModularContext<NDigits>::ToResidue(Limb* residue, const BigInteger<NDigits>& value) const {
+    BigInteger<NDigits> reduced = Reduce(value);
+    big_integer_detail::Copy(residue, reduced.number_, reduced.active_blocks_);
+    big_integer_detail::Zero(residue + reduced.active_blocks_, arithmetic_.Size() - reduced.active_blocks_);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> ModularContext<NDigits>::FromResidue(const Limb* residue) const {
+    BigInteger<NDigits> result;
+    size_t size = big_integer_detail::Normalize(residue, arithmetic_.Size());
+    result.Reserve(size);
+    big_integer_detail::Copy(result.number_, residue, size);
+    result.active_blocks_ = size;
+    return result;
+}
+
+template <size_t NDigits>
+const BigInteger<NDigits>& ModularContext<NDigits>::Modulus() const {
+    return modulus_;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> ModularContext<NDigits>::Reduce(const BigInteger<NDigits>& value) const {
+    BigInteger<NDigits> result = value % modulus_;
+    if (result.IsNegative()) {
+        result += modulus_;
+    }
+    return result;
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> ModularContext<NDigits>::Multiply(const BigInteger<NDigits>& first,
+                                                      const BigInteger<NDigits>& second) const {
+    size_t size = arithmetic_.Size();
+    std::unique_ptr<Limb[]> buffer(new Limb[2 * size + arithmetic_.ScratchSize()]);
+    Limb* a = buffer.get();
+    Limb* b = a + size;
+    Limb* scratch = b + size;
+    ToResidue(a, first);
+    ToResidue(b, second);
+    // The working form of a times the plain b is the plain product in both representations.
+    arithmetic_.ToForm(a, a, scratch);
+    arithmetic_.Multiply(a, a, b, scratch);
+    return FromResidue(a);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> ModularContext<NDigits>::Pow(const BigInteger<NDigits>& base,
+                                                 const BigInteger<NDigits>& exponent) const {
+    if (exponent.IsNegative()) {
+        throw BigIntegerNegativeExponent{};
+    }
+    std::unique_ptr<Limb[]> residue(new Limb[arithmetic_.Size()]);
+    ToResidue(residue.get(), base);
+    big_integer_detail::PowSlidingWindow(residue.get(), residue.get(), exponent.number_, exponent.active_blocks_,
+                                         arithmetic_);
+    return FromResidue(residue.get());
+}
+
+// base^exponent modulo |modulus|, a ModularContext saves the setup when the modulus is reused.
+template <size_t NDigits>
+BigInteger<NDigits> PowMod(const BigInteger<NDigits>& base, const BigInteger<NDigits>& exponent,
+                           const BigInteger<NDigits>& modulus) {
+    return ModularContext<NDigits>(modulus).Pow(base, exponent);
+}
+
+template <size_t NDigits>
+BigInteger<NDigits> Sqrt(const BigInteger<NDigits>& value) {
+    return ISqrtRem(value).first;
+}
+
+// The inverse of value modulo |modulus| in [0, |modulus|), throws BigIntegerNotInvertible unless the
+// two are coprime.
+template <size_t NDigits>
+BigInteger<NDigits> ModInverse(const BigInteger<NDigits>& value, const BigInteger<NDigits>& modulus) {
+    if (!modulus) {
+        throw BigIntegerDivisionByZero{};
+    }
+    std::tuple<BigInteger<NDigits>, BigInteger<NDigits>, BigInteger<NDigits>> gcd = ExtGcd(value, modulus);
+    if (!(std::get<0>(gcd) == BigInteger<NDigits>(1))) {
+        throw BigIntegerNotInvertible{};
+    }
+    return std::get<1>(gcd);
+}
+
+// Product of the values in [first, last) as a balanced product tree, so the large multiplications come
+// last and benefit from the fast algorithms. Subtrees run on the thread pool once it has threads.
+template <class Iterator>
+typename std::iterator_traits<Iterator>::value_type ProductOf(Iterator first, Iterator last) {
+    using Value = typename std::iterator_traits<Iterator>::value_type;
+    const typename std::iterator_traits<Iterator>::difference_type kSerialCount = 16;
+    auto count = std::distance(first, last);
+    if (count <= kSerialCount) {
+        Value product(1);
+        for (; first != last; ++first) {
+            product *= *first;
+        }
+        return product;
+    }
+    Iterator middle = first;
+    std::advance(middle, count / 2);
+    Value halves[2];
+    big_integer_detail::ThreadPool::Instance().Run(
+        2, [&](size_t i) { halves[i] = (i == 0) ? ProductOf(first, middle) : ProductOf(middle, last); });
+    halves[0] *= halves[1];
+    return std::move(halves[0]);
+}
+
 #endif
@@ -0,0 +1,393 @@
+// Benchmarks of big_integer.h and its fixed-width siblings. There is no build target, compile it directly:
+//
+//     g++ -O2 -std=c++17 -pthread big_integer_benchmark.cpp -o big_integer_benchmark
+//
+// Every benchmark is named operation/backend/digits and reports the time per operation and the
+// throughput in operand digits per second. Options:
+//
+//     --filter=TEXT        run only the benchmarks whose name contains TEXT
+//     --min-time=SECONDS   minimum measured time per benchmark, 0.5 by default
+//     --max-digits=N       skip operand sizes above N, 1000000 by default
+//     --csv                print comma separated values instead of a table
+//     --karatsuba=N, --toom3=N, --ntt=N, --parallel=N
+//                          MultiplicationThresholds
+//     --newton=N           DivisionThresholds
+//     --threads=N          worker threads of ThreadPool::Instance()
+//
+// Threshold tuning compares two runs, e.g. of --filter=multiply/dynamic with --toom3=160 and
+// --toom3=240. The dynamic backend is BigInteger, the static and wide backends are StaticBigInteger
+// and UInt sized for the operands, which only exist up to a few thousand digits.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "big_integer.h"
+#include "static_big_integer.h"
+#include "wide_integer.h"
+
+namespace {
+
+constexpr size_t kMaxDigits = 1000000;
+// Products and dividends have twice the digits of the operands.
+using DynamicInteger = BigInteger<2 * kMaxDigits>;
+
+// Keeps the compiler from dropping the computation of value or hoisting it out of the loop: the
+// address escapes into an opaque statement that may read and write any memory.
+template <class T>
+void DoNotOptimize(T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Passed to every benchmark, which sets up its operands and then loops while KeepRunning(). Only the
+// loop is timed.
+class BenchmarkState {
+private:
+    using Clock = std::chrono::steady_clock;
+    size_t iterations_;
+    size_t remaining_;
+    size_t digits_;
+    Clock::time_point start_;
+    double seconds_;
+
+public:
+    BenchmarkState(size_t iterations, size_t digits)
+        : iterations_(iterations), remaining_(iterations), digits_(digits), seconds_(0) {
+    }
+
+    bool KeepRunning() {
+        if (remaining_ == iterations_) {
+            start_ = Clock::now();
+        }
+        if (remaining_ == 0) {
+            seconds_ = std::chrono::duration<double>(Clock::now() - start_).count();
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    // Operand size the benchmark was registered with.
+    size_t Digits() const {
+        return digits_;
+    }
+
+    // Duration of the loop once it is done.
+    double Seconds() const {
+        return seconds_;
+    }
+};
+
+struct Benchmark {
+    std::string name;
+    size_t digits;
+    std::function<void(BenchmarkState&)> function;
+};
+
+std::vector<Benchmark>& Registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Options {
+    std::string filter;
+    double min_time = 0.5;
+    size_t max_digits = kMaxDigits;
+    bool csv = false;
+};
+
+// Random decimal number of exactly digits digits, the same for the same seed.
+std::string RandomDigits(size_t digits, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::string result(digits, '0');
+    for (size_t i = 0; i < digits; ++i) {
+        result[i] = static_cast<char>('0' + digit(generator));
+    }
+    result[0] = static_cast<char>('1' + digit(generator) % 9);
+    return result;
+}
+
+template <class T>
+T Parse(const std::string& digits) {
+    T value;
+    value.FromString(digits.data(), digits.size());
+    return value;
+}
+
+// Operands of the same size with a > b, so that a - b stays non-negative for the unsigned backends.
+template <class T>
+void MakeOperands(size_t digits, T* a, T* b) {
+    std::string first = RandomDigits(digits, 1);
+    std::string second = first;
+    second[0] = (first[0] == '9') ? '8' : static_cast<char>(first[0] + 1);
+    *a = Parse<T>(second);
+    *b = Parse<T>(first);
+}
+
+template <class T>
+void BenchmarkConstruct(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    while (state.KeepRunning()) {
+        DoNotOptimize(a);
+        T copy(a);
+        DoNotOptimize(copy);
+    }
+}
+
+template <class T>
+void BenchmarkParse(BenchmarkState& state) {
+    std::string digits = RandomDigits(state.Digits(), 1);
+    T value;
+    while (state.KeepRunning()) {
+        value.FromString(digits.data(), digits.size());
+        DoNotOptimize(value);
+    }
+}
+
+template <class T>
+void BenchmarkPrint(BenchmarkState& state) {
+    T value = Parse<T>(RandomDigits(state.Digits(), 1));
+    std::vector<char> buffer(value.MaxStringLength());
+    while (state.KeepRunning()) {
+        DoNotOptimize(value);
+        size_t length = value.ToString(buffer.data());
+        DoNotOptimize(length);
+    }
+}
+
+template <class T>
+void BenchmarkAdd(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    T result;
+    while (state.KeepRunning()) {
+        DoNotOptimize(a);
+        result = a + b;
+        DoNotOptimize(result);
+    }
+}
+
+template <class T>
+void BenchmarkSubtract(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    T result;
+    while (state.KeepRunning()) {
+        DoNotOptimize(a);
+        result = a - b;
+        DoNotOptimize(result);
+    }
+}
+
+template <class T>
+void BenchmarkCompare(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    // Only the lowest limbs differ.
+    b = a - 1;
+    while (state.KeepRunning()) {
+        DoNotOptimize(a);
+        bool less = b < a;
+        DoNotOptimize(less);
+    }
+}
+
+template <class T>
+void BenchmarkMultiply(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    T result;
+    while (state.KeepRunning()) {
+        DoNotOptimize(a);
+        result = a * b;
+        DoNotOptimize(result);
+    }
+}
+
+// A dividend of 2 * digits digits by a divisor of digits digits, the shape Newton division is for.
+template <class T>
+void BenchmarkDivide(BenchmarkState& state) {
+    T a;
+    T b;
+    MakeOperands(state.Digits(), &a, &b);
+    T dividend = a * b + Parse<T>(RandomDigits(state.Digits(), 2));
+    T result;
+    while (state.KeepRunning()) {
+        DoNotOptimize(dividend);
+        result = dividend / b;
+        DoNotOptimize(result);
+    }
+}
+
+void Register(const std::string& operation, const std::string& backend, size_t digits,
+              std::function<void(BenchmarkState&)> function) {
+    Registry().push_back(Benchmark{operation + "/" + backend + "/" + std::to_string(digits), digits, function});
+}
+
+template <class T>
+void RegisterArithmetic(const std::string& backend, size_t digits) {
+    Register("construct", backend, digits, BenchmarkConstruct<T>);
+    Register("parse", backend, digits, BenchmarkParse<T>);
+    Register("add", backend, digits, BenchmarkAdd<T>);
+    Register("subtract", backend, digits, BenchmarkSubtract<T>);
+    Register("compare", backend, digits, BenchmarkCompare<T>);
+    Register("multiply", backend, digits, BenchmarkMultiply<T>);
+    Register("divide", backend, digits, BenchmarkDivide<T>);
+}
+
+// StaticBigInteger has no ToString of its own, it prints through BigInteger, so it has no print
+// benchmark.
+template <class T>
+void RegisterAll(const std::string& backend, size_t digits) {
+    RegisterArithmetic<T>(backend, digits);
+    Register("print", backend, digits, BenchmarkPrint<T>);
+}
+
+// Bits of a UInt that holds every number of digits decimal digits.
+constexpr size_t WideBits(size_t digits) {
+    return (digits * 3322 / 1000 / big_integer_detail::kLimbBits + 2) * big_integer_detail::kLimbBits;
+}
+
+template <size_t NDigits>
+void RegisterFixedWidth() {
+    RegisterArithmetic<StaticBigInteger<2 * NDigits>>("static", NDigits);
+    RegisterAll<UInt<WideBits(2 * NDigits)>>("wide", NDigits);
+}
+
+void RegisterBenchmarks() {
+    for (size_t digits = 1; digits <= kMaxDigits; digits *= 10) {
+        RegisterAll<DynamicInteger>("dynamic", digits);
+    }
+    RegisterFixedWidth<1>();
+    RegisterFixedWidth<10>();
+    RegisterFixedWidth<100>();
+    RegisterFixedWidth<1000>();
+}
+
+// Runs the benchmark with growing iteration counts until one run takes at least min_time, returns the
+// nanoseconds per iteration of that run.
+double Measure(const Benchmark& benchmark, double min_time, size_t* iterations) {
+    size_t count = 1;
+    while (true) {
+        BenchmarkState state(count, benchmark.digits);
+        benchmark.function(state);
+        double seconds = state.Seconds();
+        if (seconds >= min_time || count >= (static_cast<size_t>(1) << 40)) {
+            *iterations = count;
+            return seconds * 1e9 / static_cast<double>(count);
+        }
+        // Aim a little past min_time, but grow at most tenfold at a time since short runs are noisy.
+        double factor = (seconds > 0) ? min_time * 1.4 / seconds : 10;
+        factor = (factor > 10) ? 10 : (factor < 2) ? 2 : factor;
+        count = static_cast<size_t>(static_cast<double>(count) * factor);
+    }
+}
+
+std::string FormatRate(double per_second) {
+    const char* kUnits[] = {"", "k", "M", "G", "T"};
+    size_t unit = 0;
+    while (per_second >= 1000 && unit + 1 < sizeof(kUnits) / sizeof(kUnits[0])) {
+        per_second /= 1000;
+        ++unit;
+    }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.3g %sdigit/s", per_second, kUnits[unit]);
+    return buffer;
+}
+
+bool ParseOption(const char* argument, const char* name, const char** value) {
+    size_t length = strlen(name);
+    if (strncmp(argument, name, length) != 0 || argument[length] != '=') {
+        return false;
+    }
+    *value = argument + length + 1;
+    return true;
+}
+
+size_t ParseSize(const char* value) {
+    return static_cast<size_t>(strtoull(value, nullptr, 10));
+}
+
+bool ParseArguments(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* value = nullptr;
+        if (strcmp(argv[i], "--csv") == 0) {
+            options->csv = true;
+        } else if (ParseOption(argv[i], "--filter", &value)) {
+            options->filter = value;
+        } else if (ParseOption(argv[i], "--min-time", &value)) {
+            options->min_time = strtod(value, nullptr);
+        } else if (ParseOption(argv[i], "--max-digits", &value)) {
+            options->max_digits = ParseSize(value);
+        } else if (ParseOption(argv[i], "--karatsuba", &value)) {
+            GetMultiplicationThresholds().karatsuba = ParseSize(value);
+        } else if (ParseOption(argv[i], "--toom3", &value)) {
+            GetMultiplicationThresholds().toom3 = ParseSize(value);
+        } else if (ParseOption(argv[i], "--ntt", &value)) {
+            GetMultiplicationThresholds().ntt = ParseSize(value);
+        } else if (ParseOption(argv[i], "--parallel", &value)) {
+            GetMultiplicationThresholds().parallel = ParseSize(value);
+        } else if (ParseOption(argv[i], "--newton", &value)) {
+            GetDivisionThresholds().newton = ParseSize(value);
+        } else if (ParseOption(argv[i], "--threads", &value)) {
+            big_integer_detail::ThreadPool::Instance().SetThreadCount(ParseSize(value));
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseArguments(argc, argv, &options)) {
+        return 1;
+    }
+    RegisterBenchmarks();
+    const MultiplicationThresholds& multiplication = GetMultiplicationThresholds();
+    printf("# karatsuba=%zu toom3=%zu ntt=%zu parallel=%zu newton=%zu threads=%zu\n", multiplication.karatsuba,
+           multiplication.toom3, multiplication.ntt, multiplication.parallel, GetDivisionThresholds().newton,
+           big_integer_detail::ThreadPool::Instance().ThreadCount());
+    if (options.csv) {
+        printf("name,iterations,ns_per_op,digits_per_second\n");
+    } else {
+        printf("%-28s %12s %16s %20s\n", "Benchmark", "Iterations", "Time", "Throughput");
+    }
+    for (const Benchmark& benchmark : Registry()) {
+        if (benchmark.digits > options.max_digits ||
+            benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        size_t iterations = 0;
+        double nanoseconds = Measure(benchmark, options.min_time, &iterations);
+        double digits_per_second = static_cast<double>(benchmark.digits) * 1e9 / nanoseconds;
+        if (options.csv) {
+            printf("%s,%zu,%.1f,%.0f\n", benchmark.name.c_str(), iterations, nanoseconds, digits_per_second);
+        } else {
+            printf("%-28s %12zu %13.1f ns %20s\n", benchmark.name.c_str(), iterations, nanoseconds,
+                   FormatRate(digits_per_second).c_str());
+        }
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#ifndef BIG_INTEGER_BITS_H
+#define BIG_INTEGER_BITS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "division.h"
+#include "limbs.h"
+
+// Byte order of the raw byte images of BigInteger::ToBytes and BigInteger::FromBytes.
+enum class BigIntegerByteOrder { kLittleEndian, kBigEndian };
+
+namespace big_integer_detail {
+
+// Number of significant bits of a normalized a, 0 for zero.
+inline size_t BitLength(const Limb* a, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    return size * kLimbBits - CountLeadingZeros(a[size - 1]);
+}
+
+inline size_t PopCount(Limb value) {
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    value = (value + (value >> 4)) & 0x0F0F0F0F;
+    return static_cast<size_t>((value * 0x01010101) >> 24);
+}
+
+enum class BitwiseOperation { kAnd, kOr, kXor };
+
+inline Limb ApplyBitwise(BitwiseOperation operation, Limb a, Limb b) {
+    switch (operation) {
+        case BitwiseOperation::kAnd:
+            return a & b;
+        case BitwiseOperation::kOr:
+            return a | b;
+        default:
+            return a ^ b;
+    }
+}
+
+// Limbs of a sign-magnitude number in two's complement, produced from the bottom up: the limbs of -a
+// are those of ~(a - 1), and beyond the magnitude come copies of the sign.
+class TwosComplementReader {
+private:
+    const Limb* limbs_;
+    size_t size_;
+    bool negative_;
+    Limb borrow_;
+
+public:
+    TwosComplementReader(const Limb* limbs, size_t size, bool negative)
+        : limbs_(limbs), size_(size), negative_(negative), borrow_(1) {
+    }
+
+    // Limb i, called with i = 0, 1, 2, ... in turn.
+    Limb Next(size_t i) {
+        Limb value = (i < size_) ? limbs_[i] : 0;
+        if (!negative_) {
+            return value;
+        }
+        Limb decremented = value - borrow_;
+        borrow_ = (value < borrow_) ? 1 : 0;
+        return ~decremented;
+    }
+};
+
+// r = a op b for sign-magnitude operands with the semantics of infinite two's complement. r has
+// max(a_size, b_size) + 1 limbs and may alias a or b; it receives the magnitude of the result, the
+// return value is its sign.
+inline bool Bitwise(BitwiseOperation operation, Limb* r, const Limb* a, size_t a_size, bool a_negative,
+                    const Limb* b, size_t b_size, bool b_negative) {
+    size_t size = ((a_size > b_size) ? a_size : b_size) + 1;
+    TwosComplementReader a_reader(a, a_size, a_negative);
+    TwosComplementReader b_reader(b, b_size, b_negative);
+    bool negative = ApplyBitwise(operation, a_negative ? 1 : 0, b_negative ? 1 : 0) != 0;
+    Limb carry = 1;
+    for (size_t i = 0; i < size; ++i) {
+        Limb value = ApplyBitwise(operation, a_reader.Next(i), b_reader.Next(i));
+        if (negative) {
+            // The magnitude of a negative result is ~value + 1.
+            value = ~value + carry;
+            carry = (value < carry) ? 1 : 0;
+        }
+        r[i] = value;
+    }
+    return negative;
+}
+
+// Writes the count bytes of the little-endian image of a normalized a (zero padded) in the given order.
+inline void ToBytes(uint8_t* out, size_t count, const Limb* a, size_t size, BigIntegerByteOrder order) {
+    const size_t kLimbBytes = kLimbBits / 8;
+    for (size_t i = 0; i < count; ++i) {
+        size_t limb = i / kLimbBytes;
+        uint8_t value = (limb < size) ? static_cast<uint8_t>(a[limb] >> (8 * (i % kLimbBytes))) : 0;
+        out[(order == BigIntegerByteOrder::kLittleEndian) ? i : count - 1 - i] = value;
+    }
+}
+
+// r = the number of the count bytes in the given order, r has (count + 3) / 4 limbs. Returns the
+// normalized size of r.
+inline size_t FromBytes(Limb* r, const uint8_t* bytes, size_t count, BigIntegerByteOrder order) {
+    const size_t kLimbBytes = kLimbBits / 8;
+    size_t size = (count + kLimbBytes - 1) / kLimbBytes;
+    Zero(r, size);
+    for (size_t i = 0; i < count; ++i) {
+        Limb value = bytes[(order == BigIntegerByteOrder::kLittleEndian) ? i : count - 1 - i];
+        r[i / kLimbBytes] |= value << (8 * (i % kLimbBytes));
+    }
+    return Normalize(r, size);
+}
+
+// Bits per digit of a power of two base from 2 to 32, 0 for other bases.
+constexpr size_t DigitBits(unsigned base) {
+    for (size_t bits = 1; bits <= 5; ++bits) {
+        if (base == (1u << bits)) {
+            return bits;
+        }
+    }
+    return 0;
+}
+
+// Number of digits of width bits needed for a normalized a, at least one.
+inline size_t BinaryDigits(const Limb* a, size_t size, size_t bits) {
+    size_t length = BitLength(a, size);
+    return (length == 0) ? 1 : (length + bits - 1) / bits;
+}
+
+// Writes the digits digits of width bits of a, most significant first, in lower case.
+inline void ToBinaryRadix(char* out, size_t digits, const Limb* a, size_t size, size_t bits) {
+    const char kDigits[] = "0123456789abcdefghijklmnopqrstuv";
+    Limb mask = (static_cast<Limb>(1) << bits) - 1;
+    for (size_t i = 0; i < digits; ++i) {
+        size_t position = i * bits;
+        size_t limb = position / kLimbBits;
+        size_t offset = position % kLimbBits;
+        Limb value = (limb < size) ? a[limb] >> offset : 0;
+        if (offset + bits > kLimbBits && limb + 1 < size) {
+            value |= a[limb + 1] << (kLimbBits - offset);
+        }
+        out[digits - 1 - i] = kDigits[value & mask];
+    }
+}
+
+constexpr Limb DigitValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return static_cast<Limb>(c - '0');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<Limb>(c - 'a' + 10);
+    }
+    return static_cast<Limb>(c - 'A' + 10);
+}
+
+// r = the number written by the length digits of width bits in str, r has
+// (length * bits + kLimbBits - 1) / kLimbBits limbs. Returns the normalized size of r.
+inline size_t FromBinaryRadix(Limb* r, const char* str, size_t length, size_t bits) {
+    size_t size = (length * bits + kLimbBits - 1) / kLimbBits;
+    Limb mask = (static_cast<Limb>(1) << bits) - 1;
+    Zero(r, size);
+    for (size_t i = 0; i < length; ++i) {
+        Limb value = DigitValue(str[length - 1 - i]) & mask;
+        size_t position = i * bits;
+        size_t limb = position / kLimbBits;
+        size_t offset = position % kLimbBits;
+        r[limb] |= value << offset;
+        if (offset + bits > kLimbBits) {
+            r[limb + 1] |= value >> (kLimbBits - offset);
+        }
+    }
+    return Normalize(r, size);
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_BITS_H
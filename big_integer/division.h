@@ -0,0 +1,208 @@
+#ifndef BIG_INTEGER_DIVISION_H
+#define BIG_INTEGER_DIVISION_H
+
+#include <memory>
+
+#include "limbs.h"
+#include "multiplication.h"
+
+// Divisor size (in limbs) from which division goes through a Newton reciprocal instead of
+// schoolbook long division. The quotient has to be at least as long for the switch to pay off.
+struct DivisionThresholds {
+    size_t newton = 4000;
+};
+
+inline DivisionThresholds& GetDivisionThresholds() {
+    static DivisionThresholds thresholds;
+    return thresholds;
+}
+
+namespace big_integer_detail {
+
+constexpr size_t CountLeadingZeros(Limb value) {
+    size_t count = 0;
+    for (Limb mask = static_cast<Limb>(1) << (kLimbBits - 1); mask != 0 && (value & mask) == 0; mask >>= 1) {
+        ++count;
+    }
+    return count;
+}
+
+// Knuth's Algorithm D. u has u_size + 1 limbs (the top one takes the overflow of the normalization
+// shift), d has d_size limbs with the top bit set and the quotient must fit into u_size - d_size + 1
+// limbs, which q receives. The remainder is left in the low d_size limbs of u.
+constexpr void DivModSchoolbook(Limb* q, Limb* u, size_t u_size, const Limb* d, size_t d_size) {
+    if (d_size == 1) {
+        DoubleLimb remainder = u[u_size];
+        for (size_t i = u_size; i > 0; --i) {
+            DoubleLimb current = (remainder << kLimbBits) | u[i - 1];
+            q[i - 1] = static_cast<Limb>(current / d[0]);
+            remainder = current % d[0];
+            u[i] = 0;
+        }
+        u[0] = static_cast<Limb>(remainder);
+        return;
+    }
+    const DoubleLimb base = static_cast<DoubleLimb>(1) << kLimbBits;
+    Limb top = d[d_size - 1];
+    Limb next = d[d_size - 2];
+    for (size_t j = u_size - d_size + 1; j > 0; --j) {
+        Limb* window = u + j - 1;
+        DoubleLimb numerator = (static_cast<DoubleLimb>(window[d_size]) << kLimbBits) | window[d_size - 1];
+        DoubleLimb estimate = numerator / top;
+        DoubleLimb rest = numerator % top;
+        while (estimate >= base || estimate * next > ((rest << kLimbBits) | window[d_size - 2])) {
+            --estimate;
+            rest += top;
+            if (rest >= base) {
+                break;
+            }
+        }
+        Limb borrow = SubMul1(window, d, d_size, static_cast<Limb>(estimate));
+        Limb high = window[d_size];
+        window[d_size] = high - borrow;
+        if (high < borrow) {
+            --estimate;
+            window[d_size] += AddNScalar(window, window, d, d_size);
+        }
+        q[j - 1] = static_cast<Limb>(estimate);
+    }
+}
+
+// Whether the 2 * size + 1 limbs of a exceed 2^(kLimbBits * 2 * size).
+inline bool AbovePower(const Limb* a, size_t size) {
+    if (a[2 * size] != 1) {
+        return a[2 * size] > 1;
+    }
+    return Normalize(a, 2 * size) != 0;
+}
+
+// v = floor(2^(kLimbBits * 2 * size) / d) with the top bit of d set, v has size + 1 limbs. Large
+// divisors take the reciprocal of their upper half and refine it with one Newton step
+// x += x * (2^(kLimbBits * 2 * size) - d * x) / 2^(kLimbBits * 2 * size), which doubles the precision.
+inline void Reciprocal(Limb* v, const Limb* d, size_t size) {
+    if (size < GetDivisionThresholds().newton) {
+        std::unique_ptr<Limb[]> numerator(new Limb[2 * size + 1]);
+        Zero(numerator.get(), 2 * size);
+        numerator[2 * size] = 1;
+        DivModSchoolbook(v, numerator.get(), 2 * size, d, size);
+        return;
+    }
+    size_t high = (size + 1) / 2;
+    size_t low = size - high;
+    size_t product_size = 2 * size + 1;
+    std::unique_ptr<Limb[]> buffer(new Limb[3 * product_size + size + 1]);
+    Limb* product = buffer.get();
+    Limb* sum = product + product_size;
+    Limb* correction = sum + product_size;
+
+    Zero(v, low);
+    Reciprocal(v + low, d + low, high);
+
+    // error = 2^(kLimbBits * 2 * size) - d * v in two's complement over product_size limbs.
+    Mul(product, v, size + 1, d, size);
+    Negate(product, product_size);
+    product[2 * size] += 1;
+    bool negative = (product[2 * size] >> (kLimbBits - 1)) != 0;
+    if (negative) {
+        Negate(product, product_size);
+    }
+    size_t error_size = Normalize(product, product_size);
+    if (error_size != 0) {
+        Mul(correction, v, size + 1, product, error_size);
+        size_t correction_size = size + 1 + error_size;
+        if (correction_size > 2 * size) {
+            correction_size = Normalize(correction + 2 * size, correction_size - 2 * size);
+            if (correction_size > size + 1) {
+                correction_size = size + 1;
+            }
+            if (negative) {
+                Sub(v, v, size + 1, correction + 2 * size, correction_size);
+            } else {
+                Add(v, v, size + 1, correction + 2 * size, correction_size);
+            }
+        }
+    }
+
+    // The refined value is off by a few units at most, fix it against the exact product.
+    Mul(product, v, size + 1, d, size);
+    while (AbovePower(product, size)) {
+        SubBorrow(v, v, size + 1, 1);
+        Sub(product, product, product_size, d, size);
+    }
+    for (;;) {
+        Add(sum, product, product_size, d, size);
+        if (AbovePower(sum, size)) {
+            break;
+        }
+        AddCarry(v, v, size + 1, 1);
+        Copy(product, sum, product_size);
+    }
+}
+
+// q = a / d and r = a % d for a of 2 * size limbs below d * 2^(kLimbBits * size), with the top bit
+// of d set and v = Reciprocal(d). q and r have size limbs each.
+inline void DivModReciprocal(Limb* q, Limb* r, const Limb* a, const Limb* d, const Limb* v, size_t size) {
+    std::unique_ptr<Limb[]> buffer(new Limb[5 * size + 1]);
+    Limb* product = buffer.get();
+    Limb* rest = product + 3 * size + 1;
+    // v <= 2^(kLimbBits * 2 * size) / d, so the estimate never exceeds the quotient and misses it by
+    // at most two.
+    Mul(product, a, 2 * size, v, size + 1);
+    Copy(q, product + 2 * size, size);
+    Mul(product, q, size, d, size);
+    Sub(rest, a, 2 * size, product, 2 * size);
+    while (Compare(rest, d, size) >= 0 || Normalize(rest + size, size) != 0) {
+        Sub(rest, rest, 2 * size, d, size);
+        AddCarry(q, q, size, 1);
+    }
+    Copy(r, rest, size);
+}
+
+// Same contract as DivModSchoolbook: the numerator is cut into pieces of d_size limbs that are
+// divided from the top, each together with the remainder of the previous step.
+inline void DivModNewton(Limb* q, Limb* u, size_t u_size, const Limb* d, size_t d_size) {
+    size_t numerator_size = u_size + 1;
+    size_t pieces = (numerator_size + d_size - 1) / d_size;
+    std::unique_ptr<Limb[]> buffer(new Limb[(pieces + 3) * d_size + 1]);
+    Limb* reciprocal = buffer.get();
+    Limb* window = reciprocal + d_size + 1;
+    Limb* quotient = window + 2 * d_size;
+    Reciprocal(reciprocal, d, d_size);
+    Zero(window + d_size, d_size);
+    for (size_t piece = pieces; piece > 0; --piece) {
+        size_t offset = (piece - 1) * d_size;
+        size_t length = (numerator_size - offset < d_size) ? numerator_size - offset : d_size;
+        Copy(window, u + offset, length);
+        Zero(window + length, d_size - length);
+        DivModReciprocal(quotient + offset, window + d_size, window, d, reciprocal, d_size);
+    }
+    Copy(q, quotient, u_size - d_size + 1);
+    Copy(u, window + d_size, d_size);
+    Zero(u + d_size, numerator_size - d_size);
+}
+
+// q = a / b and r = a % b with a_size >= b_size > 0 and b normalized. q has a_size - b_size + 1 limbs,
+// r has b_size limbs, neither may alias a or b.
+inline void DivMod(Limb* q, Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    if (b_size == 1) {
+        r[0] = DivMod1(q, a, a_size, b[0]);
+        return;
+    }
+    size_t shift = CountLeadingZeros(b[b_size - 1]);
+    std::unique_ptr<Limb[]> buffer(new Limb[a_size + 1 + b_size]);
+    Limb* u = buffer.get();
+    Limb* d = u + a_size + 1;
+    u[a_size] = ShiftLeft(u, a, a_size, shift);
+    ShiftLeft(d, b, b_size, shift);
+    const DivisionThresholds& thresholds = GetDivisionThresholds();
+    if (b_size >= thresholds.newton && a_size - b_size >= thresholds.newton) {
+        DivModNewton(q, u, a_size, d, b_size);
+    } else {
+        DivModSchoolbook(q, u, a_size, d, b_size);
+    }
+    ShiftRight(r, u, b_size, shift);
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_DIVISION_H
@@ -0,0 +1,410 @@
+#ifndef BIG_INTEGER_EXPRESSION_H
+#define BIG_INTEGER_EXPRESSION_H
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "big_integer.h"
+
+// Lazy arithmetic on BigInteger. Wrapping an operand with Lazy() makes +, -, *, / and % build an
+// expression tree instead of computing temporaries; the tree is evaluated when it is assigned to,
+// added to or subtracted from a BigInteger:
+//
+//     result = Lazy(a) * b + Lazy(c) * d - e;
+//     acc += Lazy(a) * b;
+//
+// Sums are accumulated directly into the destination, products inside sums go through AddMul/SubMul,
+// and every intermediate value that still has to exist lives in a thread-local arena of BigInteger
+// objects whose buffers are reused by later evaluations. Products take their temporaries from the
+// thread-local scratch of multiplication.h, so a warm evaluation below the NTT threshold does not
+// allocate. Integer operands such as Lazy(a) + 5 are kept by value, BigInteger operands by
+// reference, so the tree has to be evaluated within the statement that builds it.
+
+// Intermediate values of expression evaluation, acquired and released in stack order.
+template <size_t NDigits>
+class ExpressionArena {
+private:
+    std::vector<std::unique_ptr<BigInteger<NDigits>>> values_;
+    size_t used_ = 0;
+
+public:
+    static ExpressionArena& Local() {
+        thread_local ExpressionArena arena;
+        return arena;
+    }
+
+    BigInteger<NDigits>& Acquire() {
+        if (used_ == values_.size()) {
+            values_.emplace_back(new BigInteger<NDigits>());
+        }
+        return *values_[used_++];
+    }
+
+    void Release() {
+        --used_;
+    }
+
+    // A value of the arena held for the lifetime of the slot.
+    class Slot {
+    private:
+        ExpressionArena& arena_;
+        BigInteger<NDigits>& value_;
+
+    public:
+        explicit Slot(ExpressionArena& arena) : arena_(arena), value_(arena.Acquire()) {
+        }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        ~Slot() {
+            arena_.Release();
+        }
+
+        BigInteger<NDigits>& Get() {
+            return value_;
+        }
+    };
+};
+
+template <size_t NDigits>
+class BigIntegerTerm {
+private:
+    const BigInteger<NDigits>* value_;
+
+public:
+    using Value = BigInteger<NDigits>;
+
+    explicit BigIntegerTerm(const Value& value) : value_(&value) {
+    }
+
+    const Value* Leaf() const {
+        return value_;
+    }
+
+    bool References(const Value* value) const {
+        return value_ == value;
+    }
+
+    void EvaluateInto(Value& destination, ExpressionArena<NDigits>&) const {
+        destination = *value_;
+    }
+
+    void AccumulateInto(Value& destination, bool subtract, ExpressionArena<NDigits>&) const {
+        if (subtract) {
+            destination -= *value_;
+        } else {
+            destination += *value_;
+        }
+    }
+
+    void EvaluateTo(Value& destination) const {
+        destination = *value_;
+    }
+
+    void AccumulateTo(Value& destination, bool subtract) const {
+        AccumulateInto(destination, subtract, ExpressionArena<NDigits>::Local());
+    }
+};
+
+// An integer operand of an expression, kept by value.
+template <size_t NDigits>
+class IntegerTerm {
+private:
+    int64_t value_;
+
+public:
+    using Value = BigInteger<NDigits>;
+
+    explicit IntegerTerm(int64_t value) : value_(value) {
+    }
+
+    const Value* Leaf() const {
+        return nullptr;
+    }
+
+    bool References(const Value*) const {
+        return false;
+    }
+
+    void EvaluateInto(Value& destination, ExpressionArena<NDigits>&) const {
+        destination = Value(value_);
+    }
+
+    void AccumulateInto(Value& destination, bool subtract, ExpressionArena<NDigits>&) const {
+        if (subtract) {
+            destination -= value_;
+        } else {
+            destination += value_;
+        }
+    }
+
+    void EvaluateTo(Value& destination) const {
+        destination = Value(value_);
+    }
+
+    void AccumulateTo(Value& destination, bool subtract) const {
+        AccumulateInto(destination, subtract, ExpressionArena<NDigits>::Local());
+    }
+};
+
+template <size_t NDigits>
+BigIntegerTerm<NDigits> Lazy(const BigInteger<NDigits>& value) {
+    return BigIntegerTerm<NDigits>(value);
+}
+
+// The value of a node: the operand itself for a leaf, otherwise an arena slot held until destruction.
+template <class Node>
+class MaterializedOperand {
+private:
+    using Value = typename Node::Value;
+    static constexpr size_t kDigits = IsBigIntegerExpression<Node>::kDigits;
+    const Value* value_;
+    ExpressionArena<kDigits>* arena_;
+
+public:
+    MaterializedOperand(const Node& node, ExpressionArena<kDigits>& arena) : value_(node.Leaf()), arena_(nullptr) {
+        if (value_ == nullptr) {
+            Value& slot = arena.Acquire();
+            try {
+                node.EvaluateInto(slot, arena);
+            } catch (...) {
+                arena.Release();
+                throw;
+            }
+            arena_ = &arena;
+            value_ = &slot;
+        }
+    }
+
+    MaterializedOperand(const MaterializedOperand&) = delete;
+    MaterializedOperand& operator=(const MaterializedOperand&) = delete;
+
+    ~MaterializedOperand() {
+        if (arena_ != nullptr) {
+            arena_->Release();
+        }
+    }
+
+    const Value& Get() const {
+        return *value_;
+    }
+};
+
+enum class ExpressionOperation { kAdd, kSubtract, kMultiply, kDivide, kModulo };
+
+template <ExpressionOperation Operation, class Left, class Right>
+class BinaryExpression {
+private:
+    static constexpr size_t kDigits = IsBigIntegerExpression<Left>::kDigits;
+    Left left_;
+    Right right_;
+
+public:
+    using Value = BigInteger<kDigits>;
+
+    BinaryExpression(const Left& left, const Right& right) : left_(left), right_(right) {
+    }
+
+    const Value* Leaf() const {
+        return nullptr;
+    }
+
+    bool References(const Value* value) const {
+        return left_.References(value) || right_.References(value);
+    }
+
+    // destination = *this, destination is not referenced by the expression.
+    void EvaluateInto(Value& destination, ExpressionArena<kDigits>& arena) const {
+        left_.EvaluateInto(destination, arena);
+        if (Operation == ExpressionOperation::kAdd || Operation == ExpressionOperation::kSubtract) {
+            right_.AccumulateInto(destination, Operation == ExpressionOperation::kSubtract, arena);
+            return;
+        }
+        MaterializedOperand<Right> right(right_, arena);
+        if (Operation == ExpressionOperation::kMultiply) {
+            destination *= right.Get();
+        } else if (Operation == ExpressionOperation::kDivide) {
+            destination /= right.Get();
+        } else {
+            destination %= right.Get();
+        }
+    }
+
+    // destination += *this or destination -= *this, destination is not referenced by the expression.
+    void AccumulateInto(Value& destination, bool subtract, ExpressionArena<kDigits>& arena) const {
+        if (Operation == ExpressionOperation::kAdd || Operation == ExpressionOperation::kSubtract) {
+            left_.AccumulateInto(destination, subtract, arena);
+            right_.AccumulateInto(destination, subtract != (Operation == ExpressionOperation::kSubtract), arena);
+        } else if (Operation == ExpressionOperation::kMultiply) {
+            MaterializedOperand<Left> left(left_, arena);
+            MaterializedOperand<Right> right(right_, arena);
+            if (subtract) {
+                SubMul(destination, left.Get(), right.Get());
+            } else {
+                AddMul(destination, left.Get(), right.Get());
+            }
+        } else {
+            typename ExpressionArena<kDigits>::Slot slot(arena);
+            EvaluateInto(slot.Get(), arena);
+            if (subtract) {
+                destination -= slot.Get();
+            } else {
+                destination += slot.Get();
+            }
+        }
+    }
+
+    // Entry points used by BigInteger, they detour through the arena when the destination is an operand.
+    void EvaluateTo(Value& destination) const {
+        ExpressionArena<kDigits>& arena = ExpressionArena<kDigits>::Local();
+        if (!References(&destination)) {
+            EvaluateInto(destination, arena);
+            return;
+        }
+        typename ExpressionArena<kDigits>::Slot slot(arena);
+        EvaluateInto(slot.Get(), arena);
+        std::swap(destination, slot.Get());
+    }
+
+    void AccumulateTo(Value& destination, bool subtract) const {
+        ExpressionArena<kDigits>& arena = ExpressionArena<kDigits>::Local();
+        if (!References(&destination)) {
+            AccumulateInto(destination, subtract, arena);
+            return;
+        }
+        typename ExpressionArena<kDigits>::Slot slot(arena);
+        EvaluateInto(slot.Get(), arena);
+        if (subtract) {
+            destination -= slot.Get();
+        } else {
+            destination += slot.Get();
+        }
+    }
+};
+
+template <size_t NDigits>
+struct IsBigIntegerExpression<BigIntegerTerm<NDigits>> : std::true_type {
+    static constexpr size_t kDigits = NDigits;
+};
+
+template <size_t NDigits>
+struct IsBigIntegerExpression<IntegerTerm<NDigits>> : std::true_type {
+    static constexpr size_t kDigits = NDigits;
+};
+
+template <ExpressionOperation Operation, class Left, class Right>
+struct IsBigIntegerExpression<BinaryExpression<Operation, Left, Right>> : std::true_type {
+    static constexpr size_t kDigits = IsBigIntegerExpression<Left>::kDigits;
+};
+
+// Integers that convert to int64_t without changing their value.
+template <class Operand>
+struct IsIntegerOperand
+    : std::integral_constant<bool, std::is_integral<Operand>::value && !std::is_same<Operand, bool>::value &&
+                                       (std::is_signed<Operand>::value || sizeof(Operand) < sizeof(int64_t))> {};
+
+// Expression node of an operand: BigInteger values and integers become leaves, expressions stay as they
+// are. Integer leaves take NDigits from the expression on the other side.
+template <class Operand, size_t NDigits, bool = IsIntegerOperand<Operand>::value>
+struct ExpressionNode {
+    using Type = Operand;
+
+    static const Operand& Make(const Operand& operand) {
+        return operand;
+    }
+};
+
+template <size_t NOperandDigits, size_t NDigits>
+struct ExpressionNode<BigInteger<NOperandDigits>, NDigits, false> {
+    using Type = BigIntegerTerm<NOperandDigits>;
+
+    static Type Make(const BigInteger<NOperandDigits>& operand) {
+        return Type(operand);
+    }
+};
+
+template <class Operand, size_t NDigits>
+struct ExpressionNode<Operand, NDigits, true> {
+    using Type = IntegerTerm<NDigits>;
+
+    static Type Make(const Operand operand) {
+        return Type(static_cast<int64_t>(operand));
+    }
+};
+
+template <class Operand>
+struct IsBigIntegerValue : std::false_type {};
+
+template <size_t NDigits>
+struct IsBigIntegerValue<BigInteger<NDigits>> : std::true_type {};
+
+// NDigits of the expression side of an operator, 0 when neither side is one.
+template <class Left, class Right, bool = IsBigIntegerExpression<Left>::value,
+          bool = IsBigIntegerExpression<Right>::value>
+struct ExpressionDigits : std::integral_constant<size_t, 0> {};
+
+template <class Left, class Right, bool NRight>
+struct ExpressionDigits<Left, Right, true, NRight>
+    : std::integral_constant<size_t, IsBigIntegerExpression<Left>::kDigits> {};
+
+template <class Left, class Right>
+struct ExpressionDigits<Left, Right, false, true>
+    : std::integral_constant<size_t, IsBigIntegerExpression<Right>::kDigits> {};
+
+// Operators take part when at least one side is an expression and the other one is an expression, a
+// BigInteger or an integer; plain BigInteger operands keep the eager operators.
+template <class Operand>
+struct IsExpressionOperand
+    : std::integral_constant<bool, IsBigIntegerExpression<Operand>::value || IsBigIntegerValue<Operand>::value ||
+                                       IsIntegerOperand<Operand>::value> {};
+
+template <class Left, class Right>
+struct ExpressionOperands
+    : std::integral_constant<bool, (IsBigIntegerExpression<Left>::value || IsBigIntegerExpression<Right>::value) &&
+                                       IsExpressionOperand<Left>::value && IsExpressionOperand<Right>::value> {};
+
+template <class Operand, class Left, class Right>
+using ExpressionNodeOf = ExpressionNode<Operand, ExpressionDigits<Left, Right>::value>;
+
+template <ExpressionOperation Operation, class Left, class Right>
+using ExpressionResult =
+    typename std::enable_if<ExpressionOperands<Left, Right>::value,
+                            BinaryExpression<Operation, typename ExpressionNodeOf<Left, Left, Right>::Type,
+                                             typename ExpressionNodeOf<Right, Left, Right>::Type>>::type;
+
+template <ExpressionOperation Operation, class Left, class Right>
+ExpressionResult<Operation, Left, Right> MakeExpression(const Left& left, const Right& right) {
+    return ExpressionResult<Operation, Left, Right>(ExpressionNodeOf<Left, Left, Right>::Make(left),
+                                                    ExpressionNodeOf<Right, Left, Right>::Make(right));
+}
+
+template <class Left, class Right>
+ExpressionResult<ExpressionOperation::kAdd, Left, Right> operator+(const Left& left, const Right& right) {
+    return MakeExpression<ExpressionOperation::kAdd>(left, right);
+}
+
+template <class Left, class Right>
+ExpressionResult<ExpressionOperation::kSubtract, Left, Right> operator-(const Left& left, const Right& right) {
+    return MakeExpression<ExpressionOperation::kSubtract>(left, right);
+}
+
+template <class Left, class Right>
+ExpressionResult<ExpressionOperation::kMultiply, Left, Right> operator*(const Left& left, const Right& right) {
+    return MakeExpression<ExpressionOperation::kMultiply>(left, right);
+}
+
+template <class Left, class Right>
+ExpressionResult<ExpressionOperation::kDivide, Left, Right> operator/(const Left& left, const Right& right) {
+    return MakeExpression<ExpressionOperation::kDivide>(left, right);
+}
+
+template <class Left, class Right>
+ExpressionResult<ExpressionOperation::kModulo, Left, Right> operator%(const Left& left, const Right& right) {
+    return MakeExpression<ExpressionOperation::kModulo>(left, right);
+}
+
+#endif  // BIG_INTEGER_EXPRESSION_H
@@ -0,0 +1,248 @@
+#ifndef BIG_INTEGER_LIMBS_H
+#define BIG_INTEGER_LIMBS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd.h"
+
+// Kernels over little-endian arrays of binary limbs. Sizes are passed explicitly,
+// "normalized" means the most significant limb is non-zero (zero has size 0).
+namespace big_integer_detail {
+
+using Limb = uint32_t;
+using DoubleLimb = uint64_t;
+constexpr size_t kLimbBits = 32;
+
+constexpr size_t Normalize(const Limb* a, size_t size) {
+    while (size > 0 && a[size - 1] == 0) {
+        --size;
+    }
+    return size;
+}
+
+// The Scalar kernels are the portable loops behind the vectorized ones, also usable in constant
+// expressions.
+constexpr int CompareScalar(const Limb* a, const Limb* b, size_t size) {
+    for (size_t i = size; i > 0; --i) {
+        if (a[i - 1] != b[i - 1]) {
+            return (a[i - 1] < b[i - 1]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+constexpr int CompareScalar(const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    if (a_size != b_size) {
+        return (a_size < b_size) ? -1 : 1;
+    }
+    return CompareScalar(a, b, a_size);
+}
+
+inline int Compare(const Limb* a, const Limb* b, size_t size) {
+#if BIG_INTEGER_HAS_AVX2_KERNELS
+    if (size >= kSimdMinLimbs && HasAvx2()) {
+        return CompareAvx2(a, b, size);
+    }
+#endif
+    return CompareScalar(a, b, size);
+}
+
+inline int Compare(const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    if (a_size != b_size) {
+        return (a_size < b_size) ? -1 : 1;
+    }
+    return Compare(a, b, a_size);
+}
+
+constexpr void Copy(Limb* to, const Limb* from, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        to[i] = from[i];
+    }
+}
+
+constexpr void Zero(Limb* a, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = 0;
+    }
+}
+
+// r = a + b over size limbs, returns the carry out. r may alias a or b.
+constexpr Limb AddNScalar(Limb* r, const Limb* a, const Limb* b, size_t size) {
+    DoubleLimb carry = 0;
+    for (size_t i = 0; i < size; ++i) {
+        carry += static_cast<DoubleLimb>(a[i]) + b[i];
+        r[i] = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+    return static_cast<Limb>(carry);
+}
+
+inline Limb AddN(Limb* r, const Limb* a, const Limb* b, size_t size) {
+#if BIG_INTEGER_HAS_AVX2_KERNELS
+    if (size >= kSimdMinLimbs && HasAvx2()) {
+        return AddNAvx2(r, a, b, size);
+    }
+#endif
+    return AddNScalar(r, a, b, size);
+}
+
+// r = a + carry over size limbs, returns the carry out. r may alias a.
+constexpr Limb AddCarry(Limb* r, const Limb* a, size_t size, Limb carry) {
+    size_t i = 0;
+    for (; i < size && carry != 0; ++i) {
+        r[i] = a[i] + carry;
+        carry = (r[i] < carry) ? 1 : 0;
+    }
+    if (r != a) {
+        Copy(r + i, a + i, size - i);
+    }
+    return carry;
+}
+
+// r = a + b with a_size >= b_size, r has a_size limbs, returns the carry out.
+inline Limb Add(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    Limb carry = AddN(r, a, b, b_size);
+    return AddCarry(r + b_size, a + b_size, a_size - b_size, carry);
+}
+
+// r = a - b over size limbs, returns the borrow out. r may alias a or b.
+constexpr Limb SubNScalar(Limb* r, const Limb* a, const Limb* b, size_t size) {
+    Limb borrow = 0;
+    for (size_t i = 0; i < size; ++i) {
+        DoubleLimb diff = static_cast<DoubleLimb>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<Limb>(diff);
+        borrow = static_cast<Limb>(diff >> (2 * kLimbBits - 1));
+    }
+    return borrow;
+}
+
+inline Limb SubN(Limb* r, const Limb* a, const Limb* b, size_t size) {
+#if BIG_INTEGER_HAS_AVX2_KERNELS
+    if (size >= kSimdMinLimbs && HasAvx2()) {
+        return SubNAvx2(r, a, b, size);
+    }
+#endif
+    return SubNScalar(r, a, b, size);
+}
+
+// r = a - borrow over size limbs, returns the borrow out. r may alias a.
+constexpr Limb SubBorrow(Limb* r, const Limb* a, size_t size, Limb borrow) {
+    size_t i = 0;
+    for (; i < size && borrow != 0; ++i) {
+        Limb value = a[i];
+        r[i] = value - borrow;
+        borrow = (value < borrow) ? 1 : 0;
+    }
+    if (r != a) {
+        Copy(r + i, a + i, size - i);
+    }
+    return borrow;
+}
+
+// r = a - b with a_size >= b_size, r has a_size limbs, returns the borrow out.
+inline Limb Sub(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    Limb borrow = SubN(r, a, b, b_size);
+    return SubBorrow(r + b_size, a + b_size, a_size - b_size, borrow);
+}
+
+// r = a << shift with shift < kLimbBits, returns the bits shifted out. r may alias a.
+constexpr Limb ShiftLeft(Limb* r, const Limb* a, size_t size, size_t shift) {
+    if (shift == 0) {
+        Copy(r, a, size);
+        return 0;
+    }
+    Limb out = 0;
+    for (size_t i = size; i > 0; --i) {
+        Limb value = a[i - 1];
+        if (i == size) {
+            out = value >> (kLimbBits - shift);
+        }
+        r[i - 1] = (value << shift) | ((i > 1) ? (a[i - 2] >> (kLimbBits - shift)) : 0);
+    }
+    return out;
+}
+
+// r = a >> shift with shift < kLimbBits, returns the bits shifted out (in the high end of the limb).
+// r may alias a.
+constexpr Limb ShiftRight(Limb* r, const Limb* a, size_t size, size_t shift) {
+    if (shift == 0) {
+        Copy(r, a, size);
+        return 0;
+    }
+    Limb out = (size > 0) ? (a[0] << (kLimbBits - shift)) : 0;
+    for (size_t i = 0; i < size; ++i) {
+        r[i] = (a[i] >> shift) | ((i + 1 < size) ? (a[i + 1] << (kLimbBits - shift)) : 0);
+    }
+    return out;
+}
+
+// r = a * factor + carry, returns the high limb. r may alias a.
+constexpr Limb Mul1(Limb* r, const Limb* a, size_t size, Limb factor, Limb carry = 0) {
+    DoubleLimb acc = carry;
+    for (size_t i = 0; i < size; ++i) {
+        acc += static_cast<DoubleLimb>(a[i]) * factor;
+        r[i] = static_cast<Limb>(acc);
+        acc >>= kLimbBits;
+    }
+    return static_cast<Limb>(acc);
+}
+
+// r += a * factor over size limbs, returns the high limb.
+constexpr Limb AddMul1(Limb* r, const Limb* a, size_t size, Limb factor) {
+    DoubleLimb acc = 0;
+    for (size_t i = 0; i < size; ++i) {
+        acc += static_cast<DoubleLimb>(a[i]) * factor + r[i];
+        r[i] = static_cast<Limb>(acc);
+        acc >>= kLimbBits;
+    }
+    return static_cast<Limb>(acc);
+}
+
+// r -= a * factor over size limbs, returns the high limb of what could not be subtracted.
+constexpr Limb SubMul1(Limb* r, const Limb* a, size_t size, Limb factor) {
+    DoubleLimb borrow = 0;
+    for (size_t i = 0; i < size; ++i) {
+        DoubleLimb product = static_cast<DoubleLimb>(a[i]) * factor + borrow;
+        Limb low = static_cast<Limb>(product);
+        borrow = (product >> kLimbBits) + ((r[i] < low) ? 1 : 0);
+        r[i] -= low;
+    }
+    return static_cast<Limb>(borrow);
+}
+
+// q = a / divisor, returns the remainder. q may alias a.
+constexpr Limb DivMod1(Limb* q, const Limb* a, size_t size, Limb divisor) {
+    DoubleLimb remainder = 0;
+    for (size_t i = size; i > 0; --i) {
+        DoubleLimb current = (remainder << kLimbBits) | a[i - 1];
+        q[i - 1] = static_cast<Limb>(current / divisor);
+        remainder = current % divisor;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+// a mod divisor, without writing the quotient.
+constexpr Limb Mod1(const Limb* a, size_t size, Limb divisor) {
+    DoubleLimb remainder = 0;
+    for (size_t i = size; i > 0; --i) {
+        remainder = ((remainder << kLimbBits) | a[i - 1]) % divisor;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+// r = a * b, r has a_size + b_size limbs and must not alias a or b.
+constexpr void MulSchoolbook(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    if (a_size == 0 || b_size == 0) {
+        Zero(r, a_size + b_size);
+        return;
+    }
+    r[a_size] = Mul1(r, a, a_size, b[0]);
+    for (size_t i = 1; i < b_size; ++i) {
+        r[a_size + i] = AddMul1(r + i, a, a_size, b[i]);
+    }
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_LIMBS_H
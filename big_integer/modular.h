@@ -0,0 +1,190 @@
+#ifndef BIG_INTEGER_MODULAR_H
+#define BIG_INTEGER_MODULAR_H
+
+#include <memory>
+#include <vector>
+
+#include "division.h"
+#include "limbs.h"
+#include "multiplication.h"
+
+namespace big_integer_detail {
+
+// -m^-1 modulo 2^kLimbBits for an odd m, each Newton step doubles the number of correct bits.
+inline Limb NegativeInverse(Limb m) {
+    Limb inverse = 1;
+    for (size_t bits = 1; bits < kLimbBits; bits *= 2) {
+        inverse *= 2 - m * inverse;
+    }
+    return static_cast<Limb>(0) - inverse;
+}
+
+// Multiplication modulo a fixed normalized modulus on residues of exactly size limbs. Odd moduli
+// keep residues in Montgomery form a * 2^(kLimbBits * size) mod m, even ones reduce plain
+// products with Barrett's method.
+class ModularArithmetic {
+private:
+    std::vector<Limb> modulus_;
+    bool montgomery_;
+    Limb inverse_;
+    // Montgomery: 2^(2 * kLimbBits * size) mod m, Barrett: floor(2^(2 * kLimbBits * size) / m).
+    std::vector<Limb> constant_;
+
+    void ReduceMontgomery(Limb* r, Limb* t) const {
+        size_t size = modulus_.size();
+        t[2 * size] = 0;
+        for (size_t i = 0; i < size; ++i) {
+            Limb carry = AddMul1(t + i, modulus_.data(), size, t[i] * inverse_);
+            AddCarry(t + i + size, t + i + size, size + 1 - i, carry);
+        }
+        if (t[2 * size] != 0 || Compare(t + size, modulus_.data(), size) >= 0) {
+            SubN(r, t + size, modulus_.data(), size);
+        } else {
+            Copy(r, t + size, size);
+        }
+    }
+
+    // x has 2 * size limbs and is below m^2.
+    void ReduceBarrett(Limb* r, const Limb* x, Limb* scratch) const {
+        size_t size = modulus_.size();
+        Limb* estimate = scratch;
+        Limb* product = estimate + 2 * size + 3;
+        Limb* next_scratch = product + 2 * size + 1;
+        MulRecursive(estimate, x + size - 1, size + 1, constant_.data(), size + 2, next_scratch);
+        const Limb* quotient = estimate + size + 1;
+        MulRecursive(product, quotient, size + 1, modulus_.data(), size, next_scratch);
+        Limb* rest = estimate;
+        SubN(rest, x, product, size + 1);
+        while (ComparePadded(rest, size + 1, modulus_.data(), size) >= 0) {
+            Sub(rest, rest, size + 1, modulus_.data(), size);
+        }
+        Copy(r, rest, size);
+    }
+
+public:
+    ModularArithmetic(const Limb* modulus, size_t size)
+        : modulus_(modulus, modulus + size), montgomery_((modulus[0] & 1) != 0), inverse_(0) {
+        std::vector<Limb> power(2 * size + 1, 0);
+        power[2 * size] = 1;
+        std::vector<Limb> quotient(size + 2);
+        std::vector<Limb> remainder(size);
+        DivMod(quotient.data(), remainder.data(), power.data(), power.size(), modulus, size);
+        if (montgomery_) {
+            inverse_ = NegativeInverse(modulus[0]);
+            constant_ = remainder;
+        } else {
+            constant_ = quotient;
+        }
+    }
+
+    size_t Size() const {
+        return modulus_.size();
+    }
+
+    size_t ScratchSize() const {
+        size_t size = modulus_.size();
+        return 6 * size + 6 + MulScratchSize(size + 2, size + 2);
+    }
+
+    // r = a * b mod m in the working representation, r may alias a or b.
+    void Multiply(Limb* r, const Limb* a, const Limb* b, Limb* scratch) const {
+        size_t size = modulus_.size();
+        Limb* product = scratch;
+        Limb* next_scratch = product + 2 * size + 1;
+        MulRecursive(product, a, size, b, size, next_scratch);
+        if (montgomery_) {
+            ReduceMontgomery(r, product);
+        } else {
+            ReduceBarrett(r, product, next_scratch);
+        }
+    }
+
+    // r = the working representation of a residue a < m.
+    void ToForm(Limb* r, const Limb* a, Limb* scratch) const {
+        if (montgomery_) {
+            Multiply(r, a, constant_.data(), scratch);
+        } else if (r != a) {
+            Copy(r, a, modulus_.size());
+        }
+    }
+
+    // r = the residue of a value in the working representation.
+    void FromForm(Limb* r, const Limb* a, Limb* scratch) const {
+        size_t size = modulus_.size();
+        if (montgomery_) {
+            Limb* t = scratch;
+            Copy(t, a, size);
+            Zero(t + size, size);
+            ReduceMontgomery(r, t);
+        } else if (r != a) {
+            Copy(r, a, size);
+        }
+    }
+};
+
+inline bool TestBit(const Limb* a, size_t bit) {
+    return ((a[bit / kLimbBits] >> (bit % kLimbBits)) & 1) != 0;
+}
+
+// Window width of the sliding window exponentiation for an exponent of the given bit length.
+inline size_t PowWindowBits(size_t bits) {
+    const size_t kLimits[] = {8, 24, 80, 240, 672};
+    size_t window = 1;
+    for (size_t limit : kLimits) {
+        if (bits > limit) {
+            ++window;
+        }
+    }
+    return window;
+}
+
+// r = a^exponent mod m with a residue a < m, r may alias a. All buffers are allocated once up front:
+// 2^(window - 1) odd powers of a and the multiplication scratch.
+inline void PowSlidingWindow(Limb* r, const Limb* a, const Limb* exponent, size_t exponent_size,
+                             const ModularArithmetic& arithmetic) {
+    size_t size = arithmetic.Size();
+    size_t bits = exponent_size * kLimbBits;
+    while (bits > 0 && !TestBit(exponent, bits - 1)) {
+        --bits;
+    }
+    size_t window = PowWindowBits(bits);
+    size_t table_size = static_cast<size_t>(1) << (window - 1);
+    std::unique_ptr<Limb[]> buffer(new Limb[(table_size + 2) * size + arithmetic.ScratchSize()]);
+    Limb* table = buffer.get();
+    Limb* square = table + table_size * size;
+    Limb* result = square + size;
+    Limb* scratch = result + size;
+
+    Zero(result, size);
+    result[0] = 1;
+    arithmetic.ToForm(result, result, scratch);
+    arithmetic.ToForm(table, a, scratch);
+    arithmetic.Multiply(square, table, table, scratch);
+    for (size_t i = 1; i < table_size; ++i) {
+        arithmetic.Multiply(table + i * size, table + (i - 1) * size, square, scratch);
+    }
+
+    while (bits > 0) {
+        if (!TestBit(exponent, bits - 1)) {
+            arithmetic.Multiply(result, result, result, scratch);
+            --bits;
+            continue;
+        }
+        size_t low = (bits > window) ? bits - window : 0;
+        while (!TestBit(exponent, low)) {
+            ++low;
+        }
+        size_t value = 0;
+        for (size_t bit = bits; bit > low; --bit) {
+            arithmetic.Multiply(result, result, result, scratch);
+            value = 2 * value + (TestBit(exponent, bit - 1) ? 1 : 0);
+        }
+        arithmetic.Multiply(result, result, table + (value / 2) * size, scratch);
+        bits = low;
+    }
+    arithmetic.FromForm(r, result, scratch);
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_MODULAR_H
@@ -0,0 +1,346 @@
+#ifndef BIG_INTEGER_MULTIPLICATION_H
+#define BIG_INTEGER_MULTIPLICATION_H
+
+#include <memory>
+#include <utility>
+
+#include "limbs.h"
+#include "ntt.h"
+#include "thread_pool.h"
+
+// Operand sizes (in limbs of the shorter factor) from which each algorithm takes over. From parallel
+// on, the independent subproducts of Karatsuba, Toom-3 and the NTT run on ThreadPool::Instance()
+// once it has been given threads.
+struct MultiplicationThresholds {
+    size_t karatsuba = 32;
+    size_t toom3 = 160;
+    size_t ntt = 6000;
+    size_t parallel = 1500;
+};
+
+inline MultiplicationThresholds& GetMultiplicationThresholds() {
+    static MultiplicationThresholds thresholds;
+    return thresholds;
+}
+
+namespace big_integer_detail {
+
+// Upper bound of the scratch space used by MulRecursive, see the per-level usage in
+// MulKaratsuba (~3n) and MulToom3 (~4n) with subproblems of at most half the size.
+inline size_t MulScratchSize(size_t a_size, size_t b_size) {
+    return 10 * (a_size + b_size) + 4096;
+}
+
+// Temporary limbs of operations that run over and over, such as the products of operator*= and
+// AddMul: a thread-local buffer keeps its memory between calls, so that they stop allocating once it
+// has grown to the sizes in use. Requests above kKeptLimbs, and nested ones while the buffer is held,
+// get memory of their own.
+class ScratchLimbs {
+private:
+    struct Buffer {
+        std::unique_ptr<Limb[]> limbs;
+        size_t size = 0;
+        bool held = false;
+    };
+
+    static Buffer& Local() {
+        thread_local Buffer buffer;
+        return buffer;
+    }
+
+    std::unique_ptr<Limb[]> own_;
+    Limb* limbs_;
+    bool holds_;
+
+public:
+    static constexpr size_t kKeptLimbs = static_cast<size_t>(1) << 18;
+
+    explicit ScratchLimbs(size_t size) : limbs_(nullptr), holds_(false) {
+        Buffer& buffer = Local();
+        if (buffer.held || size > kKeptLimbs) {
+            own_.reset(new Limb[size]);
+            limbs_ = own_.get();
+            return;
+        }
+        if (buffer.size < size) {
+            buffer.limbs.reset(new Limb[size]);
+            buffer.size = size;
+        }
+        buffer.held = true;
+        holds_ = true;
+        limbs_ = buffer.limbs.get();
+    }
+
+    ScratchLimbs(const ScratchLimbs&) = delete;
+    ScratchLimbs& operator=(const ScratchLimbs&) = delete;
+
+    ~ScratchLimbs() {
+        if (holds_) {
+            Local().held = false;
+        }
+    }
+
+    Limb* Get() const {
+        return limbs_;
+    }
+};
+
+// r += a over r_size limbs, limbs of a beyond r_size are known to be zero.
+inline void AddInto(Limb* r, size_t r_size, const Limb* a, size_t a_size) {
+    if (a_size > r_size) {
+        a_size = r_size;
+    }
+    Add(r, r, r_size, a, a_size);
+}
+
+// Compares a and b as if the shorter one were padded with zero limbs.
+inline int ComparePadded(const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    for (; a_size > b_size; --a_size) {
+        if (a[a_size - 1] != 0) {
+            return 1;
+        }
+    }
+    for (; b_size > a_size; --b_size) {
+        if (b[b_size - 1] != 0) {
+            return -1;
+        }
+    }
+    return Compare(a, b, a_size);
+}
+
+// r = |a - b| over size limbs (a_size, b_size <= size), returns whether a < b.
+inline bool AbsDiff(Limb* r, size_t size, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    bool less = ComparePadded(a, a_size, b, b_size) < 0;
+    if (less) {
+        std::swap(a, b);
+        std::swap(a_size, b_size);
+    }
+    size_t common = (a_size < b_size) ? a_size : b_size;
+    Limb borrow = SubN(r, a, b, common);
+    SubBorrow(r + common, a + common, a_size - common, borrow);
+    Zero(r + a_size, size - a_size);
+    return less;
+}
+
+inline void Negate(Limb* a, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = ~a[i];
+    }
+    AddCarry(a, a, size, 1);
+}
+
+// a >>= 1 for a two's complement number of size limbs.
+inline void HalveSigned(Limb* a, size_t size) {
+    Limb sign = a[size - 1] >> (kLimbBits - 1);
+    ShiftRight(a, a, size, 1);
+    a[size - 1] |= sign << (kLimbBits - 1);
+}
+
+// a /= 3 modulo 2^(kLimbBits * size), exact when a is a multiple of 3.
+inline void DivExact3(Limb* a, size_t size) {
+    const Limb inverse = 0xAAAAAAABu;
+    Limb carry = 0;
+    for (size_t i = 0; i < size; ++i) {
+        Limb value = a[i];
+        Limb difference = value - carry;
+        carry = (value < carry) ? 1 : 0;
+        Limb quotient = difference * inverse;
+        a[i] = quotient;
+        carry += (quotient >= 0x55555556u) ? 1 : 0;
+        carry += (quotient >= 0xAAAAAAABu) ? 1 : 0;
+    }
+}
+
+inline void MulRecursive(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch);
+
+struct MulTask {
+    Limb* r;
+    const Limb* a;
+    size_t a_size;
+    const Limb* b;
+    size_t b_size;
+};
+
+// Computes independent products that all fit into MulScratchSize(size, size) limbs of scratch. Large
+// ones are spread over the thread pool, every task but the first one with a scratch buffer of its own.
+inline void MulTasks(const MulTask* tasks, size_t count, size_t size, Limb* scratch) {
+    ThreadPool& pool = ThreadPool::Instance();
+    if (pool.ThreadCount() == 0 || size < GetMultiplicationThresholds().parallel) {
+        for (size_t i = 0; i < count; ++i) {
+            MulRecursive(tasks[i].r, tasks[i].a, tasks[i].a_size, tasks[i].b, tasks[i].b_size, scratch);
+        }
+        return;
+    }
+    size_t scratch_size = MulScratchSize(size, size);
+    std::unique_ptr<Limb[]> extra(new Limb[(count - 1) * scratch_size]);
+    pool.Run(count, [&](size_t i) {
+        Limb* own = (i == 0) ? scratch : extra.get() + (i - 1) * scratch_size;
+        MulRecursive(tasks[i].r, tasks[i].a, tasks[i].a_size, tasks[i].b, tasks[i].b_size, own);
+    });
+}
+
+// a_size >= b_size > ceil(a_size / 2).
+inline void MulKaratsuba(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch) {
+    size_t half = (a_size + 1) / 2;
+    size_t total = a_size + b_size;
+    const Limb* a_high = a + half;
+    const Limb* b_high = b + half;
+    size_t a_high_size = a_size - half;
+    size_t b_high_size = b_size - half;
+
+    Limb* a_diff = scratch;
+    Limb* b_diff = a_diff + half;
+    Limb* middle = b_diff + half;
+    Limb* sum = middle + 2 * half;
+    Limb* next_scratch = sum + 2 * half + 1;
+
+    bool a_less = AbsDiff(a_diff, half, a, half, a_high, a_high_size);
+    bool b_less = AbsDiff(b_diff, half, b, half, b_high, b_high_size);
+
+    const MulTask tasks[] = {{r, a, half, b, half},
+                             {r + 2 * half, a_high, a_high_size, b_high, b_high_size},
+                             {middle, a_diff, half, b_diff, half}};
+    MulTasks(tasks, 3, half, next_scratch);
+
+    // a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1).
+    sum[2 * half] = Add(sum, r, 2 * half, r + 2 * half, total - 2 * half);
+    if (a_less == b_less) {
+        Sub(sum, sum, 2 * half + 1, middle, 2 * half);
+    } else {
+        Add(sum, sum, 2 * half + 1, middle, 2 * half);
+    }
+    AddInto(r + half, total - half, sum, 2 * half + 1);
+}
+
+// a_size >= b_size > 2 * ceil(a_size / 3). Evaluates at 0, 1, -1, -2 and infinity and interpolates
+// in two's complement, so the signed intermediate values need no separate sign tracking.
+inline void MulToom3(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch) {
+    size_t third = (a_size + 2) / 3;
+    size_t total = a_size + b_size;
+    size_t point_size = third + 1;
+    size_t value_size = 2 * point_size;
+    size_t a_top_size = a_size - 2 * third;
+    size_t b_top_size = b_size - 2 * third;
+
+    Limb* a_one = scratch;
+    Limb* a_minus_one = a_one + point_size;
+    Limb* a_minus_two = a_minus_one + point_size;
+    Limb* b_one = a_minus_two + point_size;
+    Limb* b_minus_one = b_one + point_size;
+    Limb* b_minus_two = b_minus_one + point_size;
+    Limb* w_one = b_minus_two + point_size;
+    Limb* w_minus_one = w_one + value_size;
+    Limb* w_minus_two = w_minus_one + value_size;
+    Limb* next_scratch = w_minus_two + value_size;
+
+    auto evaluate = [&](const Limb* x, size_t top_size, Limb* one, Limb* minus_one, Limb* minus_two) {
+        const Limb* x1 = x + third;
+        const Limb* x2 = x + 2 * third;
+        Limb* doubled = w_minus_two;
+        one[third] = Add(one, x, third, x2, top_size);
+        bool negative_one = AbsDiff(minus_one, point_size, one, point_size, x1, third);
+        Add(one, one, point_size, x1, third);
+        Zero(minus_two, point_size);
+        minus_two[top_size] = ShiftLeft(minus_two, x2, top_size, 2);
+        Add(minus_two, minus_two, point_size, x, third);
+        doubled[third] = ShiftLeft(doubled, x1, third, 1);
+        bool negative_two = AbsDiff(minus_two, point_size, minus_two, point_size, doubled, point_size);
+        return std::make_pair(negative_one, negative_two);
+    };
+    auto a_signs = evaluate(a, a_top_size, a_one, a_minus_one, a_minus_two);
+    auto b_signs = evaluate(b, b_top_size, b_one, b_minus_one, b_minus_two);
+
+    Limb* w_zero = r;
+    Limb* w_infinity = r + 4 * third;
+    size_t w_infinity_size = total - 4 * third;
+    const MulTask tasks[] = {{w_one, a_one, point_size, b_one, point_size},
+                             {w_minus_one, a_minus_one, point_size, b_minus_one, point_size},
+                             {w_minus_two, a_minus_two, point_size, b_minus_two, point_size},
+                             {w_zero, a, third, b, third},
+                             {w_infinity, a + 2 * third, a_top_size, b + 2 * third, b_top_size}};
+    MulTasks(tasks, 5, point_size, next_scratch);
+    Zero(r + 2 * third, 2 * third);
+    if (a_signs.first != b_signs.first) {
+        Negate(w_minus_one, value_size);
+    }
+    if (a_signs.second != b_signs.second) {
+        Negate(w_minus_two, value_size);
+    }
+
+    Limb* r1 = w_one;
+    Limb* r2 = w_minus_one;
+    Limb* r3 = w_minus_two;
+    SubN(r3, w_minus_two, w_one, value_size);
+    DivExact3(r3, value_size);
+    SubN(r1, w_one, w_minus_one, value_size);
+    HalveSigned(r1, value_size);
+    Sub(r2, w_minus_one, value_size, w_zero, 2 * third);
+    SubN(r3, r2, r3, value_size);
+    HalveSigned(r3, value_size);
+    Add(r3, r3, value_size, w_infinity, w_infinity_size);
+    Add(r3, r3, value_size, w_infinity, w_infinity_size);
+    AddN(r2, r2, r1, value_size);
+    Sub(r2, r2, value_size, w_infinity, w_infinity_size);
+    SubN(r1, r1, r3, value_size);
+
+    AddInto(r + third, total - third, r1, value_size);
+    AddInto(r + 2 * third, total - 2 * third, r2, value_size);
+    AddInto(r + 3 * third, total - 3 * third, r3, value_size);
+}
+
+// Splits the longer factor into pieces of b_size limbs, so every partial product is balanced.
+inline void MulUnbalanced(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch) {
+    Limb* partial = scratch;
+    Limb* next_scratch = partial + 2 * b_size;
+    MulRecursive(r, a, b_size, b, b_size, next_scratch);
+    Zero(r + 2 * b_size, a_size - b_size);
+    for (size_t offset = b_size; offset < a_size; offset += b_size) {
+        size_t piece = (a_size - offset < b_size) ? a_size - offset : b_size;
+        MulRecursive(partial, a + offset, piece, b, b_size, next_scratch);
+        AddInto(r + offset, a_size + b_size - offset, partial, piece + b_size);
+    }
+}
+
+// r = a * b with r of a_size + b_size limbs not aliasing a or b, scratch of MulScratchSize limbs.
+inline void MulRecursive(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch) {
+    if (a_size < b_size) {
+        std::swap(a, b);
+        std::swap(a_size, b_size);
+    }
+    const MultiplicationThresholds& thresholds = GetMultiplicationThresholds();
+    if (b_size < thresholds.karatsuba || b_size < 2) {
+        MulSchoolbook(r, a, a_size, b, b_size);
+    } else if (b_size >= thresholds.ntt && a_size + b_size <= kNttMaxSize) {
+        MulNtt(r, a, a_size, b, b_size);
+    } else if (b_size >= thresholds.toom3 && b_size > 2 * ((a_size + 2) / 3)) {
+        MulToom3(r, a, a_size, b, b_size, scratch);
+    } else if (b_size > (a_size + 1) / 2) {
+        MulKaratsuba(r, a, a_size, b, b_size, scratch);
+    } else {
+        MulUnbalanced(r, a, a_size, b, b_size, scratch);
+    }
+}
+
+// r = a * b, r has a_size + b_size limbs and must not alias a or b. scratch has MulScratchSize limbs.
+inline void Mul(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size, Limb* scratch) {
+    size_t shorter = (a_size < b_size) ? a_size : b_size;
+    if (shorter < GetMultiplicationThresholds().karatsuba) {
+        MulSchoolbook(r, a, a_size, b, b_size);
+        return;
+    }
+    MulRecursive(r, a, a_size, b, b_size, scratch);
+}
+
+inline void Mul(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    size_t shorter = (a_size < b_size) ? a_size : b_size;
+    if (shorter < GetMultiplicationThresholds().karatsuba) {
+        MulSchoolbook(r, a, a_size, b, b_size);
+        return;
+    }
+    std::unique_ptr<Limb[]> scratch(new Limb[MulScratchSize(a_size, b_size)]);
+    MulRecursive(r, a, a_size, b, b_size, scratch.get());
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_MULTIPLICATION_H
@@ -0,0 +1,226 @@
+#ifndef BIG_INTEGER_NTT_H
+#define BIG_INTEGER_NTT_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+
+#include "limbs.h"
+#include "thread_pool.h"
+
+namespace big_integer_detail {
+
+// 998244353 = 119 * 2^23 + 1 has the smallest power of two among the three primes.
+constexpr size_t kNttMaxLevel = 23;
+
+// Largest product (in limbs) the three-prime transform can compute exactly: every coefficient of
+// the convolution is below min(a_size, b_size) * 2^64 <= 2^86 < 998244353 * 167772161 * 469762049.
+constexpr size_t kNttMaxSize = static_cast<size_t>(1) << kNttMaxLevel;
+
+// Carries of the Chinese remainder step, __extension__ keeps -Wpedantic quiet about the GCC type.
+__extension__ typedef unsigned __int128 NttCarry;
+
+template <uint32_t Mod>
+uint32_t MulMod(uint32_t first, uint32_t second) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(first) * second % Mod);
+}
+
+template <uint32_t Mod>
+uint32_t PowMod(uint32_t base, uint64_t exponent) {
+    uint32_t result = 1;
+    while (exponent != 0) {
+        if (exponent & 1) {
+            result = MulMod<Mod>(result, base);
+        }
+        base = MulMod<Mod>(base, base);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+// x * root modulo Mod with the precomputed quotient root_shoup = floor(root * 2^32 / Mod) (Shoup's trick).
+template <uint32_t Mod>
+uint32_t MulModShoup(uint32_t x, uint32_t root, uint32_t root_shoup) {
+    uint32_t quotient = static_cast<uint32_t>((static_cast<uint64_t>(x) * root_shoup) >> 32);
+    uint32_t result = x * root - quotient * Mod;
+    return (result >= Mod) ? result - Mod : result;
+}
+
+// Twiddle factors of one prime, built once per transform length and shared by all later calls.
+// Level k holds w^j for j < 2^k where w is a primitive root of unity of order 2^(k + 1),
+// followed by their Shoup quotients.
+template <uint32_t Mod, uint32_t Generator>
+class NttTables {
+private:
+    std::mutex mutex_;
+    size_t prepared_ = 0;
+    std::array<std::unique_ptr<uint32_t[]>, kNttMaxLevel> forward_;
+    std::array<std::unique_ptr<uint32_t[]>, kNttMaxLevel> inverse_;
+
+    NttTables() = default;
+
+public:
+    static NttTables& Instance() {
+        static NttTables tables;
+        return tables;
+    }
+
+    // Makes the roots for transforms of length up to 2^level available.
+    void Prepare(size_t level) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (; prepared_ < level; ++prepared_) {
+            size_t half = static_cast<size_t>(1) << prepared_;
+            uint32_t root = PowMod<Mod>(Generator, (Mod - 1) / (2 * half));
+            uint32_t inverse_root = PowMod<Mod>(root, Mod - 2);
+            uint32_t* forward = new uint32_t[2 * half];
+            uint32_t* inverse = new uint32_t[2 * half];
+            forward_[prepared_].reset(forward);
+            inverse_[prepared_].reset(inverse);
+            forward[0] = inverse[0] = 1;
+            for (size_t j = 1; j < half; ++j) {
+                forward[j] = MulMod<Mod>(forward[j - 1], root);
+                inverse[j] = MulMod<Mod>(inverse[j - 1], inverse_root);
+            }
+            for (size_t j = 0; j < half; ++j) {
+                forward[half + j] = static_cast<uint32_t>((static_cast<uint64_t>(forward[j]) << 32) / Mod);
+                inverse[half + j] = static_cast<uint32_t>((static_cast<uint64_t>(inverse[j]) << 32) / Mod);
+            }
+        }
+    }
+
+    const uint32_t* Forward(size_t level) const {
+        return forward_[level].get();
+    }
+
+    const uint32_t* Inverse(size_t level) const {
+        return inverse_[level].get();
+    }
+};
+
+// Decimation in frequency: natural order in, bit-reversed order out.
+template <uint32_t Mod, uint32_t Generator>
+void NttForward(uint32_t* a, size_t level) {
+    const NttTables<Mod, Generator>& tables = NttTables<Mod, Generator>::Instance();
+    size_t size = static_cast<size_t>(1) << level;
+    for (size_t k = level; k > 0; --k) {
+        size_t half = static_cast<size_t>(1) << (k - 1);
+        const uint32_t* roots = tables.Forward(k - 1);
+        for (size_t start = 0; start < size; start += 2 * half) {
+            uint32_t* low = a + start;
+            uint32_t* high = low + half;
+            for (size_t j = 0; j < half; ++j) {
+                uint32_t u = low[j];
+                uint32_t v = high[j];
+                low[j] = (u + v >= Mod) ? u + v - Mod : u + v;
+                high[j] = MulModShoup<Mod>((u >= v) ? u - v : u + Mod - v, roots[j], roots[half + j]);
+            }
+        }
+    }
+}
+
+// Decimation in time: bit-reversed order in, natural order out, scaled by 2^-level.
+template <uint32_t Mod, uint32_t Generator>
+void NttInverse(uint32_t* a, size_t level) {
+    const NttTables<Mod, Generator>& tables = NttTables<Mod, Generator>::Instance();
+    size_t size = static_cast<size_t>(1) << level;
+    for (size_t k = 1; k <= level; ++k) {
+        size_t half = static_cast<size_t>(1) << (k - 1);
+        const uint32_t* roots = tables.Inverse(k - 1);
+        for (size_t start = 0; start < size; start += 2 * half) {
+            uint32_t* low = a + start;
+            uint32_t* high = low + half;
+            for (size_t j = 0; j < half; ++j) {
+                uint32_t u = low[j];
+                uint32_t v = MulModShoup<Mod>(high[j], roots[j], roots[half + j]);
+                low[j] = (u + v >= Mod) ? u + v - Mod : u + v;
+                high[j] = (u >= v) ? u - v : u + Mod - v;
+            }
+        }
+    }
+    uint32_t scale = PowMod<Mod>(PowMod<Mod>(2, level), Mod - 2);
+    for (size_t i = 0; i < size; ++i) {
+        a[i] = MulMod<Mod>(a[i], scale);
+    }
+}
+
+// result = a * b modulo Mod as a cyclic convolution of length 2^level, temp has 2^level entries.
+template <uint32_t Mod, uint32_t Generator>
+void NttConvolve(uint32_t* result, uint32_t* temp, const Limb* a, size_t a_size, const Limb* b, size_t b_size,
+                 size_t level) {
+    NttTables<Mod, Generator>::Instance().Prepare(level);
+    size_t size = static_cast<size_t>(1) << level;
+    for (size_t i = 0; i < size; ++i) {
+        result[i] = (i < a_size) ? a[i] % Mod : 0;
+    }
+    NttForward<Mod, Generator>(result, level);
+    if (a == b && a_size == b_size) {
+        for (size_t i = 0; i < size; ++i) {
+            result[i] = MulMod<Mod>(result[i], result[i]);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            temp[i] = (i < b_size) ? b[i] % Mod : 0;
+        }
+        NttForward<Mod, Generator>(temp, level);
+        for (size_t i = 0; i < size; ++i) {
+            result[i] = MulMod<Mod>(result[i], temp[i]);
+        }
+    }
+    NttInverse<Mod, Generator>(result, level);
+}
+
+// r = a * b via three number-theoretic transforms and CRT (Garner) recombination.
+// r has a_size + b_size limbs and must not alias a or b, a_size + b_size <= kNttMaxSize.
+inline void MulNtt(Limb* r, const Limb* a, size_t a_size, const Limb* b, size_t b_size) {
+    const uint32_t kMod1 = 998244353;
+    const uint32_t kMod2 = 167772161;
+    const uint32_t kMod3 = 469762049;
+    const uint32_t kGenerator = 3;
+
+    size_t total = a_size + b_size;
+    size_t level = 0;
+    while ((static_cast<size_t>(1) << level) < total - 1) {
+        ++level;
+    }
+    size_t size = static_cast<size_t>(1) << level;
+    // The three transforms are independent, with worker threads each of them gets its own temp.
+    ThreadPool& pool = ThreadPool::Instance();
+    size_t temps = (pool.ThreadCount() == 0) ? 1 : 3;
+    std::unique_ptr<uint32_t[]> buffer(new uint32_t[(3 + temps) * size]);
+    uint32_t* residues1 = buffer.get();
+    uint32_t* residues2 = residues1 + size;
+    uint32_t* residues3 = residues2 + size;
+    uint32_t* temp = residues3 + size;
+    pool.Run(3, [&](size_t i) {
+        uint32_t* own = temp + ((temps == 1) ? 0 : i * size);
+        if (i == 0) {
+            NttConvolve<kMod1, kGenerator>(residues1, own, a, a_size, b, b_size, level);
+        } else if (i == 1) {
+            NttConvolve<kMod2, kGenerator>(residues2, own, a, a_size, b, b_size, level);
+        } else {
+            NttConvolve<kMod3, kGenerator>(residues3, own, a, a_size, b, b_size, level);
+        }
+    });
+
+    const uint32_t inverse1 = PowMod<kMod2>(kMod1 % kMod2, kMod2 - 2);
+    const uint32_t inverse12 = PowMod<kMod3>(MulMod<kMod3>(kMod1 % kMod3, kMod2 % kMod3), kMod3 - 2);
+    const NttCarry mod12 = static_cast<NttCarry>(kMod1) * kMod2;
+    NttCarry carry = 0;
+    for (size_t i = 0; i < total; ++i) {
+        if (i + 1 < total) {
+            uint32_t x1 = residues1[i];
+            uint32_t x2 = residues2[i];
+            uint32_t x3 = residues3[i];
+            uint32_t v2 = MulMod<kMod2>((x2 + kMod2 - x1 % kMod2) % kMod2, inverse1);
+            uint64_t v12 = x1 + static_cast<uint64_t>(kMod1) * v2;
+            uint32_t v3 = MulMod<kMod3>(static_cast<uint32_t>((x3 + kMod3 - v12 % kMod3) % kMod3), inverse12);
+            carry += v12 + mod12 * v3;
+        }
+        r[i] = static_cast<Limb>(carry);
+        carry >>= kLimbBits;
+    }
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_NTT_H
@@ -0,0 +1,464 @@
+#ifndef BIG_INTEGER_NUMBER_THEORY_H
+#define BIG_INTEGER_NUMBER_THEORY_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "bits.h"
+#include "division.h"
+#include "limbs.h"
+#include "multiplication.h"
+
+// Operand size (in limbs) from which the greatest common divisor reduces the operands by recursing on
+// their upper halves instead of taking one Lehmer step of a single limb at a time.
+struct GcdThresholds {
+    size_t recursive = 600;
+};
+
+inline GcdThresholds& GetGcdThresholds() {
+    static GcdThresholds thresholds;
+    return thresholds;
+}
+
+namespace big_integer_detail {
+
+// A non-negative number as a normalized limb vector. The algorithms below change the sizes of their
+// values on every step, which is easier to follow with vectors than with caller-provided buffers.
+using Natural = std::vector<Limb>;
+
+inline size_t BitLength(const Natural& a) {
+    return BitLength(a.data(), a.size());
+}
+
+inline Natural NaturalFromWord(uint64_t value) {
+    Natural r;
+    for (; value != 0; value >>= kLimbBits) {
+        r.push_back(static_cast<Limb>(value));
+    }
+    return r;
+}
+
+// The 64 bits of a starting at bit shift.
+inline uint64_t WordAt(const Natural& a, size_t shift) {
+    size_t index = shift / kLimbBits;
+    size_t offset = shift % kLimbBits;
+    auto limb = [&a](size_t i) -> uint64_t { return (i < a.size()) ? a[i] : 0; };
+    uint64_t low = limb(index) | (limb(index + 1) << kLimbBits);
+    if (offset == 0) {
+        return low;
+    }
+    return (low >> offset) | (limb(index + 2) << (2 * kLimbBits - offset));
+}
+
+inline int CompareNatural(const Natural& a, const Natural& b) {
+    return Compare(a.data(), a.size(), b.data(), b.size());
+}
+
+inline Natural MulNatural(const Natural& a, const Natural& b) {
+    if (a.empty() || b.empty()) {
+        return Natural();
+    }
+    Natural r(a.size() + b.size());
+    Mul(r.data(), a.data(), a.size(), b.data(), b.size());
+    r.resize(Normalize(r.data(), r.size()));
+    return r;
+}
+
+// a += b.
+inline void AddNatural(Natural& a, const Natural& b) {
+    if (a.size() < b.size()) {
+        a.resize(b.size(), 0);
+    }
+    Limb carry = Add(a.data(), a.data(), a.size(), b.data(), b.size());
+    if (carry != 0) {
+        a.push_back(carry);
+    }
+}
+
+// a -= b for a >= b.
+inline void SubNatural(Natural& a, const Natural& b) {
+    Sub(a.data(), a.data(), a.size(), b.data(), b.size());
+    a.resize(Normalize(a.data(), a.size()));
+}
+
+inline Natural ShiftLeftNatural(const Natural& a, size_t bits) {
+    if (a.empty()) {
+        return Natural();
+    }
+    size_t words = bits / kLimbBits;
+    Natural r(words, 0);
+    r.insert(r.end(), a.begin(), a.end());
+    r.push_back(0);
+    ShiftLeft(r.data() + words, r.data() + words, a.size() + 1, bits % kLimbBits);
+    r.resize(Normalize(r.data(), r.size()));
+    return r;
+}
+
+// floor(a / 2^bits).
+inline Natural ShiftRightNatural(const Natural& a, size_t bits) {
+    size_t words = bits / kLimbBits;
+    if (words >= a.size()) {
+        return Natural();
+    }
+    Natural r(a.begin() + static_cast<std::ptrdiff_t>(words), a.end());
+    ShiftRight(r.data(), r.data(), r.size(), bits % kLimbBits);
+    r.resize(Normalize(r.data(), r.size()));
+    return r;
+}
+
+// q = a / b and a = a % b for a non-zero b, q may be null.
+inline void DivModNatural(Natural* q, Natural& a, const Natural& b) {
+    if (CompareNatural(a, b) < 0) {
+        if (q != nullptr) {
+            q->clear();
+        }
+        return;
+    }
+    Natural quotient(a.size() - b.size() + 1);
+    Natural remainder(b.size());
+    DivMod(quotient.data(), remainder.data(), a.data(), a.size(), b.data(), b.size());
+    remainder.resize(Normalize(remainder.data(), remainder.size()));
+    a.swap(remainder);
+    if (q != nullptr) {
+        quotient.resize(Normalize(quotient.data(), quotient.size()));
+        q->swap(quotient);
+    }
+}
+
+// root = floor(sqrt(a)) and remainder = a - root^2. The root of the upper half of a, scaled back, is
+// within 2^(bits / 4) below the result, and one Newton step x = (x + a / x) / 2 from there overshoots
+// by at most two, so every halving of the size costs one division and one squaring.
+inline void SqrtRem(Natural& root, Natural& remainder, const Natural& a) {
+    size_t bits = BitLength(a);
+    if (bits <= 2 * kLimbBits) {
+        const uint64_t kMaxRoot = 0xFFFFFFFF;
+        uint64_t value = WordAt(a, 0);
+        uint64_t x = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+        if (x > kMaxRoot) {
+            x = kMaxRoot;
+        }
+        while (x * x > value) {
+            --x;
+        }
+        while (x < kMaxRoot && (x + 1) * (x + 1) <= value) {
+            ++x;
+        }
+        root = NaturalFromWord(x);
+        remainder = NaturalFromWord(value - x * x);
+        return;
+    }
+    size_t shift = bits / 4;
+    Natural high_root;
+    Natural high_remainder;
+    SqrtRem(high_root, high_remainder, ShiftRightNatural(a, 2 * shift));
+    Natural x = ShiftLeftNatural(high_root, shift);
+    Natural rest = a;
+    Natural quotient;
+    DivModNatural(&quotient, rest, x);
+    AddNatural(x, quotient);
+    x = ShiftRightNatural(x, 1);
+    Natural square = MulNatural(x, x);
+    const Natural one = NaturalFromWord(1);
+    while (CompareNatural(square, a) > 0) {
+        // (x - 1)^2 = x^2 - 2x + 1.
+        AddNatural(square, one);
+        SubNatural(square, ShiftLeftNatural(x, 1));
+        SubNatural(x, one);
+    }
+    remainder = a;
+    SubNatural(remainder, square);
+    root.swap(x);
+}
+
+// (a, b) = M (a', b') between a pair and its reduction. M is a product of the steps [[1, q], [0, 1]]
+// (a' = a - q b) and [[1, 0], [q, 1]] (b' = b - q a), so its entries are non-negative and its
+// determinant is 1: a' = m11 a - m01 b and b' = m00 b - m10 a.
+struct GcdMatrix {
+    Natural m00{1};
+    Natural m01;
+    Natural m10;
+    Natural m11{1};
+};
+
+inline bool IsIdentity(const GcdMatrix& m) {
+    return m.m01.empty() && m.m10.empty();
+}
+
+inline size_t MaxEntryBits(const GcdMatrix& m) {
+    size_t bits = 0;
+    for (const Natural* entry : {&m.m00, &m.m01, &m.m10, &m.m11}) {
+        size_t length = BitLength(*entry);
+        bits = (length > bits) ? length : bits;
+    }
+    return bits;
+}
+
+// Whether a and b both exceed every entry of m. Then a reduction computed on the upper bits of a pair
+// also reduces the whole pair: for a = 2^p a_h + a_l and b = 2^p b_h + b_l with a_l, b_l < 2^p,
+// M^-1 (a, b) = 2^p M^-1 (a_h, b_h) + M^-1 (a_l, b_l), and both coordinates of the last term lie
+// above -2^p max(M), so the result stays positive when (a_h, b_h) reduces to values above max(M).
+inline bool Dominates(const Natural& a, const Natural& b, const GcdMatrix& m) {
+    for (const Natural* entry : {&m.m00, &m.m01, &m.m10, &m.m11}) {
+        if (CompareNatural(a, *entry) <= 0 || CompareNatural(b, *entry) <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// m = m * step.
+inline void MultiplyMatrix(GcdMatrix& m, const GcdMatrix& step) {
+    GcdMatrix product;
+    product.m00 = MulNatural(m.m00, step.m00);
+    AddNatural(product.m00, MulNatural(m.m01, step.m10));
+    product.m01 = MulNatural(m.m00, step.m01);
+    AddNatural(product.m01, MulNatural(m.m01, step.m11));
+    product.m10 = MulNatural(m.m10, step.m00);
+    AddNatural(product.m10, MulNatural(m.m11, step.m10));
+    product.m11 = MulNatural(m.m10, step.m01);
+    AddNatural(product.m11, MulNatural(m.m11, step.m11));
+    m = std::move(product);
+}
+
+// (a, b) = step^-1 (a, b), the caller knows both results to be non-negative.
+inline void ApplyInverse(const GcdMatrix& step, Natural& a, Natural& b) {
+    Natural next_a = MulNatural(step.m11, a);
+    SubNatural(next_a, MulNatural(step.m01, b));
+    Natural next_b = MulNatural(step.m00, b);
+    SubNatural(next_b, MulNatural(step.m10, a));
+    a.swap(next_a);
+    b.swap(next_b);
+}
+
+// A matrix of single limb entries, as produced by a Lehmer step.
+struct GcdWordMatrix {
+    Limb m00;
+    Limb m01;
+    Limb m10;
+    Limb m11;
+};
+
+// x * p + y * q.
+inline Natural LinearCombination(const Natural& x, Limb p, const Natural& y, Limb q) {
+    size_t size = ((x.size() > y.size()) ? x.size() : y.size()) + 2;
+    Natural r(size, 0);
+    Limb carry = AddMul1(r.data(), x.data(), x.size(), p);
+    AddCarry(r.data() + x.size(), r.data() + x.size(), size - x.size(), carry);
+    carry = AddMul1(r.data(), y.data(), y.size(), q);
+    AddCarry(r.data() + y.size(), r.data() + y.size(), size - y.size(), carry);
+    r.resize(Normalize(r.data(), r.size()));
+    return r;
+}
+
+// x * p - y * q, the caller knows the result to be non-negative.
+inline Natural LinearDifference(const Natural& x, Limb p, const Natural& y, Limb q) {
+    size_t size = ((x.size() > y.size()) ? x.size() : y.size()) + 1;
+    Natural r(size, 0);
+    r[x.size()] = Mul1(r.data(), x.data(), x.size(), p);
+    Limb borrow = SubMul1(r.data(), y.data(), y.size(), q);
+    SubBorrow(r.data() + y.size(), r.data() + y.size(), size - y.size(), borrow);
+    r.resize(Normalize(r.data(), r.size()));
+    return r;
+}
+
+inline GcdMatrix MatrixProduct(const GcdMatrix& m, const GcdWordMatrix& step) {
+    GcdMatrix product;
+    product.m00 = LinearCombination(m.m00, step.m00, m.m01, step.m10);
+    product.m01 = LinearCombination(m.m00, step.m01, m.m01, step.m11);
+    product.m10 = LinearCombination(m.m10, step.m00, m.m11, step.m10);
+    product.m11 = LinearCombination(m.m10, step.m01, m.m11, step.m11);
+    return product;
+}
+
+// (next_a, next_b) = step^-1 (a, b), the caller knows both results to be non-negative.
+inline void ApplyInverse(const GcdWordMatrix& step, const Natural& a, const Natural& b, Natural& next_a,
+                         Natural& next_b) {
+    next_a = LinearDifference(a, step.m11, b, step.m01);
+    next_b = LinearDifference(b, step.m00, a, step.m10);
+}
+
+// Whether x + q * y < limit, without overflow.
+inline bool SumBelow(uint64_t x, uint64_t q, uint64_t y, uint64_t limit) {
+    if (x >= limit) {
+        return false;
+    }
+    return y == 0 || q <= (limit - 1 - x) / y;
+}
+
+// Lehmer's step: Euclid's algorithm on the upper 64 bits a and b of a pair, continued as long as the
+// reduced values dominate the matrix (see Dominates). Returns false if not even one step qualifies.
+// The entries stay below 2^32, since max(a, b) >= max(M) * min(a', b') > max(M)^2.
+inline bool LehmerMatrix(uint64_t a, uint64_t b, GcdWordMatrix* matrix) {
+    uint64_t m00 = 1;
+    uint64_t m01 = 0;
+    uint64_t m10 = 0;
+    uint64_t m11 = 1;
+    bool reduced = false;
+    while (a != 0 && b != 0) {
+        if (a >= b) {
+            uint64_t q = a / b;
+            uint64_t rest = a - q * b;
+            uint64_t limit = (rest < b) ? rest : b;
+            if (m00 >= limit || m10 >= limit || !SumBelow(m01, q, m00, limit) || !SumBelow(m11, q, m10, limit)) {
+                break;
+            }
+            m01 += q * m00;
+            m11 += q * m10;
+            a = rest;
+        } else {
+            uint64_t q = b / a;
+            uint64_t rest = b - q * a;
+            uint64_t limit = (rest < a) ? rest : a;
+            if (m01 >= limit || m11 >= limit || !SumBelow(m00, q, m01, limit) || !SumBelow(m10, q, m11, limit)) {
+                break;
+            }
+            m00 += q * m01;
+            m10 += q * m11;
+            b = rest;
+        }
+        reduced = true;
+    }
+    *matrix = GcdWordMatrix{static_cast<Limb>(m00), static_cast<Limb>(m01), static_cast<Limb>(m10),
+                            static_cast<Limb>(m11)};
+    return reduced;
+}
+
+// Lehmer's step on the upper 64 bits of the pair, see LehmerMatrix.
+inline bool LehmerStep(const Natural& a, const Natural& b, GcdWordMatrix* matrix) {
+    size_t bits = BitLength((CompareNatural(a, b) >= 0) ? a : b);
+    size_t shift = (bits > 2 * kLimbBits) ? bits - 2 * kLimbBits : 0;
+    return LehmerMatrix(WordAt(a, shift), WordAt(b, shift), matrix);
+}
+
+// One step of Euclid's algorithm, the larger of a and b (both non-zero) is reduced modulo the smaller.
+// step receives the matrix unless it is null.
+inline void DivisionStep(Natural& a, Natural& b, GcdMatrix* step) {
+    bool reduce_a = CompareNatural(a, b) >= 0;
+    Natural quotient;
+    DivModNatural((step != nullptr) ? &quotient : nullptr, reduce_a ? a : b, reduce_a ? b : a);
+    if (step != nullptr) {
+        *step = GcdMatrix();
+        (reduce_a ? step->m01 : step->m10).swap(quotient);
+    }
+}
+
+// Reduces (a, b) to a pair that still dominates the reduction matrix, which takes about half of the
+// bits: matrix receives M with (a, b) = M (a', b'), and a', b' replace a and b. The steps come from
+// recursing on the upper bits of the current pair and are kept only while the dominance holds,
+// otherwise the window shrinks down to Lehmer steps and single quotients. By Dominates, the caller
+// may apply the matrix to any longer pair whose upper bits are (a, b).
+inline void ReduceDominated(Natural& a, Natural& b, GcdMatrix& matrix) {
+    matrix = GcdMatrix();
+    if (!Dominates(a, b, matrix)) {
+        return;
+    }
+    size_t recursive_bits = GetGcdThresholds().recursive * kLimbBits;
+    while (true) {
+        size_t bits = BitLength((CompareNatural(a, b) >= 0) ? a : b);
+        size_t room = bits - MaxEntryBits(matrix);
+        size_t window = room - room / 4;
+        if (window > bits / 2) {
+            window = bits / 2;
+        }
+        bool committed = false;
+        while (!committed) {
+            GcdMatrix step;
+            GcdMatrix product;
+            Natural next_a;
+            Natural next_b;
+            bool reduced = false;
+            if (window >= recursive_bits) {
+                next_a = ShiftRightNatural(a, bits - window);
+                next_b = ShiftRightNatural(b, bits - window);
+                ReduceDominated(next_a, next_b, step);
+                reduced = !IsIdentity(step);
+                if (reduced) {
+                    next_a = a;
+                    next_b = b;
+                    ApplyInverse(step, next_a, next_b);
+                }
+            } else if (window > 0) {
+                GcdWordMatrix word;
+                reduced = LehmerStep(a, b, &word);
+                if (reduced) {
+                    ApplyInverse(word, a, b, next_a, next_b);
+                    product = MatrixProduct(matrix, word);
+                }
+            } else {
+                next_a = a;
+                next_b = b;
+                DivisionStep(next_a, next_b, &step);
+                reduced = true;
+            }
+            if (reduced && !IsIdentity(step)) {
+                product = matrix;
+                MultiplyMatrix(product, step);
+            }
+            if (reduced) {
+                if (Dominates(next_a, next_b, product)) {
+                    a.swap(next_a);
+                    b.swap(next_b);
+                    matrix = std::move(product);
+                    committed = true;
+                    continue;
+                }
+            }
+            if (window == 0) {
+                return;
+            }
+            window = (window >= recursive_bits) ? window / 2 : 0;
+        }
+    }
+}
+
+// Reduces (a, b) to (g, 0) or (0, g) with g = gcd(a, b). matrix receives M with (a, b) = M (a', b')
+// between the original and the final pair unless it is null.
+inline void ReduceToGcd(Natural& a, Natural& b, GcdMatrix* matrix) {
+    if (matrix != nullptr) {
+        *matrix = GcdMatrix();
+    }
+    size_t recursive = GetGcdThresholds().recursive;
+    while (!a.empty() && !b.empty()) {
+        size_t size = (a.size() > b.size()) ? a.size() : b.size();
+        if (size <= 2 && matrix == nullptr) {
+            uint64_t x = WordAt(a, 0);
+            uint64_t y = WordAt(b, 0);
+            while (y != 0) {
+                uint64_t rest = x % y;
+                x = y;
+                y = rest;
+            }
+            a = NaturalFromWord(x);
+            b.clear();
+            return;
+        }
+        GcdMatrix step;
+        if (size >= 2 * recursive) {
+            ReduceDominated(a, b, step);
+        } else {
+            GcdWordMatrix word;
+            if (LehmerStep(a, b, &word)) {
+                Natural next_a;
+                Natural next_b;
+                ApplyInverse(word, a, b, next_a, next_b);
+                a.swap(next_a);
+                b.swap(next_b);
+                if (matrix != nullptr) {
+                    *matrix = MatrixProduct(*matrix, word);
+                }
+                continue;
+            }
+        }
+        if (IsIdentity(step)) {
+            DivisionStep(a, b, (matrix != nullptr) ? &step : nullptr);
+        }
+        if (matrix != nullptr) {
+            MultiplyMatrix(*matrix, step);
+        }
+    }
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_NUMBER_THEORY_H
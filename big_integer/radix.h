@@ -0,0 +1,189 @@
+#ifndef BIG_INTEGER_RADIX_H
+#define BIG_INTEGER_RADIX_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "division.h"
+#include "limbs.h"
+#include "multiplication.h"
+
+namespace big_integer_detail {
+
+constexpr Limb kDecimalBase = 1000000000;
+constexpr size_t kDecimalBaseDigits = 9;
+
+// Below these sizes decimal conversion goes chunk by chunk instead of splitting in halves.
+constexpr size_t kRadixSchoolbookDigits = 64 * kDecimalBaseDigits;
+constexpr size_t kRadixSchoolbookLimbs = 48;
+
+constexpr size_t kRadixMaxLevel = 48;
+
+// Limbs enough for any number of the given count of decimal digits, with room for the unnormalized
+// products of the conversion: 10^9 < 2^32, so every 9 digits need at most one limb.
+inline size_t LimbsForDigits(size_t digits) {
+    return digits / kDecimalBaseDigits + 2;
+}
+
+// Decimal digits enough for any number of size limbs: 32 * log10(2) < 9.633.
+inline size_t DigitsForLimbs(size_t size) {
+    return size * 9633 / 1000 + 1;
+}
+
+// Powers 10^(9 * 2^k) used to split numbers in halves, built once and shared by all later calls.
+class DecimalPowers {
+private:
+    std::mutex mutex_;
+    size_t prepared_ = 0;
+    std::array<std::vector<Limb>, kRadixMaxLevel> powers_;
+
+    DecimalPowers() = default;
+
+public:
+    static DecimalPowers& Instance() {
+        static DecimalPowers powers;
+        return powers;
+    }
+
+    // Makes the powers up to 10^(9 * 2^level) available.
+    void Prepare(size_t level) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (; prepared_ <= level; ++prepared_) {
+            if (prepared_ == 0) {
+                powers_[0].assign(1, kDecimalBase);
+                continue;
+            }
+            const std::vector<Limb>& half = powers_[prepared_ - 1];
+            std::vector<Limb>& power = powers_[prepared_];
+            power.resize(2 * half.size());
+            Mul(power.data(), half.data(), half.size(), half.data(), half.size());
+            power.resize(Normalize(power.data(), power.size()));
+        }
+    }
+
+    const std::vector<Limb>& Power(size_t level) const {
+        return powers_[level];
+    }
+};
+
+// The largest level whose power 10^(9 * 2^level) has fewer than digits digits.
+inline size_t SplitLevel(size_t digits) {
+    size_t level = 0;
+    while ((kDecimalBaseDigits << (level + 1)) < digits) {
+        ++level;
+    }
+    return level;
+}
+
+// r = 10^exponent as a product of the cached powers, returns the normalized size of r.
+// r has LimbsForDigits(exponent + 1) limbs.
+inline size_t PowerOfTen(Limb* r, size_t exponent) {
+    size_t chunks = exponent / kDecimalBaseDigits;
+    Limb factor = 1;
+    for (size_t i = 0; i < exponent % kDecimalBaseDigits; ++i) {
+        factor *= 10;
+    }
+    r[0] = factor;
+    size_t size = 1;
+    DecimalPowers& powers = DecimalPowers::Instance();
+    std::unique_ptr<Limb[]> product(new Limb[LimbsForDigits(exponent + 1)]);
+    for (size_t level = 0; (chunks >> level) != 0; ++level) {
+        if (((chunks >> level) & 1) == 0) {
+            continue;
+        }
+        powers.Prepare(level);
+        const std::vector<Limb>& power = powers.Power(level);
+        Mul(product.get(), power.data(), power.size(), r, size);
+        size = Normalize(product.get(), size + power.size());
+        Copy(r, product.get(), size);
+    }
+    return size;
+}
+
+// Writes the decimal digits of a into exactly digits characters padded with leading zeros, digits must
+// be enough for the value. a is normalized and gets destroyed.
+inline void ToDecimal(char* out, size_t digits, Limb* a, size_t size) {
+    if (size < kRadixSchoolbookLimbs || digits <= 2 * kDecimalBaseDigits) {
+        size_t position = digits;
+        while (size != 0) {
+            Limb chunk = DivMod1(a, a, size, kDecimalBase);
+            size = Normalize(a, size);
+            for (size_t i = 0; i < kDecimalBaseDigits && position > 0; ++i) {
+                out[--position] = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+        for (; position > 0; --position) {
+            out[position - 1] = '0';
+        }
+        return;
+    }
+    size_t level = SplitLevel((digits + 1) / 2);
+    size_t low_digits = kDecimalBaseDigits << level;
+    DecimalPowers& powers = DecimalPowers::Instance();
+    powers.Prepare(level);
+    const std::vector<Limb>& power = powers.Power(level);
+    if (size < power.size()) {
+        for (size_t i = 0; i < digits - low_digits; ++i) {
+            out[i] = '0';
+        }
+        ToDecimal(out + digits - low_digits, low_digits, a, size);
+        return;
+    }
+    std::unique_ptr<Limb[]> buffer(new Limb[size + 1]);
+    Limb* high = buffer.get();
+    Limb* low = high + size - power.size() + 1;
+    DivMod(high, low, a, size, power.data(), power.size());
+    ToDecimal(out, digits - low_digits, high, Normalize(high, size - power.size() + 1));
+    ToDecimal(out + digits - low_digits, low_digits, low, Normalize(low, power.size()));
+}
+
+// r = the number written by the length decimal digits of str, r has LimbsForDigits(length) limbs.
+// Returns the normalized size of r.
+inline size_t FromDecimal(Limb* r, const char* str, size_t length) {
+    if (length <= kRadixSchoolbookDigits) {
+        size_t size = 0;
+        size_t chunk = length % kDecimalBaseDigits;
+        if (chunk == 0) {
+            chunk = kDecimalBaseDigits;
+        }
+        for (size_t pos = 0; pos < length; pos += chunk, chunk = kDecimalBaseDigits) {
+            Limb factor = 1;
+            Limb value = 0;
+            for (size_t i = 0; i < chunk; ++i) {
+                factor *= 10;
+                value = value * 10 + static_cast<Limb>(str[pos + i] - '0');
+            }
+            Limb carry = Mul1(r, r, size, factor, value);
+            if (carry != 0) {
+                r[size++] = carry;
+            }
+        }
+        return size;
+    }
+    size_t level = SplitLevel(length);
+    size_t low_digits = kDecimalBaseDigits << level;
+    size_t high_digits = length - low_digits;
+    DecimalPowers& powers = DecimalPowers::Instance();
+    powers.Prepare(level);
+    const std::vector<Limb>& power = powers.Power(level);
+    std::unique_ptr<Limb[]> buffer(new Limb[LimbsForDigits(high_digits) + LimbsForDigits(low_digits)]);
+    Limb* high = buffer.get();
+    Limb* low = high + LimbsForDigits(high_digits);
+    size_t high_size = FromDecimal(high, str, high_digits);
+    size_t low_size = FromDecimal(low, str + high_digits, low_digits);
+    if (high_size == 0) {
+        Copy(r, low, low_size);
+        return low_size;
+    }
+    size_t size = high_size + power.size();
+    Mul(r, high, high_size, power.data(), power.size());
+    Add(r, r, size, low, low_size);
+    return Normalize(r, size);
+}
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_RADIX_H
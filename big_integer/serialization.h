@@ -0,0 +1,306 @@
+#ifndef BIG_INTEGER_SERIALIZATION_H
+#define BIG_INTEGER_SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "limbs.h"
+
+// Binary wire format, version 1. Every value is one record that starts with an unsigned LEB128
+// varint h:
+//
+//     h & 1 == 1: the whole value is in the varint, the magnitude is h >> 2 (below 2^62) and
+//                 bit 1 is the sign;
+//     h & 1 == 0: h >> 2 little-endian 32-bit limbs follow, the last one non-zero, bit 1 is the sign.
+//
+// Every value has a single encoding: negative zero, varints with trailing zero groups and limb records
+// of magnitudes below 2^62 are rejected, since writers use the varint form for those, so zero is the
+// single byte 0x01. A column is a header of kBigIntegerColumnHeaderLength bytes, the magic "BIGN"
+// and the format version, followed by records up to the end of the data.
+
+constexpr uint8_t kBigIntegerFormatVersion = 1;
+constexpr size_t kBigIntegerColumnHeaderLength = 5;
+
+class BigIntegerInvalidFormat : public std::runtime_error {
+public:
+    BigIntegerInvalidFormat() : std::runtime_error("BigIntegerInvalidFormat") {
+    }
+};
+
+namespace big_integer_detail {
+
+constexpr size_t kLimbBytes = kLimbBits / 8;
+constexpr size_t kMaxVarintLength = 10;
+constexpr uint64_t kVarintMagnitudeLimit = static_cast<uint64_t>(1) << 62;
+// "BIGN" read as a little-endian limb.
+constexpr Limb kColumnMagic = 0x4E474942;
+
+// Writes value as an unsigned LEB128 varint of at most kMaxVarintLength bytes, returns its length.
+inline size_t WriteVarint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+inline size_t VarintLength(uint64_t value) {
+    size_t length = 1;
+    for (; value >= 0x80; value >>= 7) {
+        ++length;
+    }
+    return length;
+}
+
+// Reads a varint from the size bytes at data, returns its length. Truncated, overlong or
+// non-minimal varints, whose last byte is a zero group, throw BigIntegerInvalidFormat.
+inline size_t ReadVarint(const uint8_t* data, size_t size, uint64_t* value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size && i < kMaxVarintLength; ++i) {
+        uint64_t bits = data[i] & 0x7F;
+        if (i == kMaxVarintLength - 1 && bits > 1) {
+            break;
+        }
+        result |= bits << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            if (i > 0 && bits == 0) {
+                break;
+            }
+            *value = result;
+            return i + 1;
+        }
+    }
+    throw BigIntegerInvalidFormat{};
+}
+
+inline Limb LoadLimb(const uint8_t* bytes) {
+    Limb value = 0;
+    for (size_t i = 0; i < kLimbBytes; ++i) {
+        value |= static_cast<Limb>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+}  // namespace big_integer_detail
+
+// Read-only value of one record, parsed in place: the limbs are read straight from the record bytes,
+// which must outlive the view. This is what lets a column in a memory-mapped file be scanned and
+// compared without building BigInteger objects.
+class BigIntegerView {
+private:
+    using Limb = big_integer_detail::Limb;
+    // Limbs of the record, nullptr for the varint form whose magnitude is small_.
+    const uint8_t* limbs_;
+    uint64_t small_;
+    size_t size_;
+    bool negative_;
+
+public:
+    BigIntegerView() : limbs_(nullptr), small_(0), size_(0), negative_(false) {
+    }
+
+    // Parses the record at the start of the size bytes at data, returns its length. Malformed or
+    // truncated records throw BigIntegerInvalidFormat.
+    size_t Parse(const uint8_t* data, size_t size) {
+        uint64_t header = 0;
+        size_t length = big_integer_detail::ReadVarint(data, size, &header);
+        negative_ = (header & 2) != 0;
+        if ((header & 1) != 0) {
+            limbs_ = nullptr;
+            small_ = header >> 2;
+            size_ = (small_ == 0) ? 0 : (small_ >> big_integer_detail::kLimbBits) == 0 ? 1 : 2;
+        } else {
+            uint64_t count = header >> 2;
+            if (count > (size - length) / big_integer_detail::kLimbBytes) {
+                throw BigIntegerInvalidFormat{};
+            }
+            limbs_ = data + length;
+            small_ = 0;
+            size_ = static_cast<size_t>(count);
+            length += size_ * big_integer_detail::kLimbBytes;
+            if (size_ != 0 && LimbAt(size_ - 1) == 0) {
+                throw BigIntegerInvalidFormat{};
+            }
+            if (size_ * big_integer_detail::kLimbBits <= 64) {
+                uint64_t magnitude = 0;
+                for (size_t i = 0; i < size_; ++i) {
+                    magnitude |= static_cast<uint64_t>(LimbAt(i)) << (big_integer_detail::kLimbBits * i);
+                }
+                if (magnitude < big_integer_detail::kVarintMagnitudeLimit) {
+                    throw BigIntegerInvalidFormat{};
+                }
+            }
+        }
+        if (negative_ && size_ == 0) {
+            throw BigIntegerInvalidFormat{};
+        }
+        return length;
+    }
+
+    bool IsNegative() const {
+        return negative_;
+    }
+
+    // Normalized number of limbs of the magnitude.
+    size_t LimbCount() const {
+        return size_;
+    }
+
+    Limb LimbAt(size_t i) const {
+        if (limbs_ == nullptr) {
+            return static_cast<Limb>(small_ >> (big_integer_detail::kLimbBits * i));
+        }
+        return big_integer_detail::LoadLimb(limbs_ + i * big_integer_detail::kLimbBytes);
+    }
+
+    // Three-way comparison of the magnitudes.
+    static int CompareAbs(const BigIntegerView& first, const BigIntegerView& second) {
+        if (first.size_ != second.size_) {
+            return (first.size_ < second.size_) ? -1 : 1;
+        }
+        for (size_t i = first.size_; i > 0; --i) {
+            Limb a = first.LimbAt(i - 1);
+            Limb b = second.LimbAt(i - 1);
+            if (a != b) {
+                return (a < b) ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Three-way comparison of the values.
+    static int Compare(const BigIntegerView& first, const BigIntegerView& second) {
+        if (first.negative_ != second.negative_) {
+            return first.negative_ ? -1 : 1;
+        }
+        int comparison = CompareAbs(first, second);
+        return first.negative_ ? -comparison : comparison;
+    }
+};
+
+inline bool operator==(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) == 0;
+}
+
+inline bool operator!=(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) != 0;
+}
+
+inline bool operator<(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) < 0;
+}
+
+inline bool operator>(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) > 0;
+}
+
+inline bool operator<=(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) <= 0;
+}
+
+inline bool operator>=(const BigIntegerView& first, const BigIntegerView& second) {
+    return BigIntegerView::Compare(first, second) >= 0;
+}
+
+// Writes the kBigIntegerColumnHeaderLength bytes of a column header.
+inline size_t WriteBigIntegerColumnHeader(uint8_t* buffer) {
+    for (size_t i = 0; i < big_integer_detail::kLimbBytes; ++i) {
+        buffer[i] = static_cast<uint8_t>(big_integer_detail::kColumnMagic >> (8 * i));
+    }
+    buffer[big_integer_detail::kLimbBytes] = kBigIntegerFormatVersion;
+    return kBigIntegerColumnHeaderLength;
+}
+
+// Forward range of views over the records of a column image, typically a memory-mapped file. The
+// header is checked on construction, records are parsed as the iteration reaches them.
+class BigIntegerColumn {
+private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+
+public:
+    class Iterator {
+    private:
+        const uint8_t* position_;
+        const uint8_t* end_;
+        size_t length_;
+        BigIntegerView view_;
+
+        void ParseCurrent() {
+            length_ = (position_ == end_) ? 0 : view_.Parse(position_, static_cast<size_t>(end_ - position_));
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BigIntegerView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const BigIntegerView*;
+        using reference = const BigIntegerView&;
+
+        Iterator() : position_(nullptr), end_(nullptr), length_(0) {
+        }
+
+        Iterator(const uint8_t* position, const uint8_t* end) : position_(position), end_(end) {
+            ParseCurrent();
+        }
+
+        const BigIntegerView& operator*() const {
+            return view_;
+        }
+
+        const BigIntegerView* operator->() const {
+            return &view_;
+        }
+
+        // Start of the current record in the column image.
+        const uint8_t* Position() const {
+            return position_;
+        }
+
+        Iterator& operator++() {
+            position_ += length_;
+            ParseCurrent();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& first, const Iterator& second) {
+            return first.position_ == second.position_;
+        }
+
+        friend bool operator!=(const Iterator& first, const Iterator& second) {
+            return first.position_ != second.position_;
+        }
+    };
+
+    // Throws BigIntegerInvalidFormat unless the size bytes at data start with a version 1 header.
+    BigIntegerColumn(const uint8_t* data, size_t size) : begin_(data), end_(data + size) {
+        if (size < kBigIntegerColumnHeaderLength) {
+            throw BigIntegerInvalidFormat{};
+        }
+        if (big_integer_detail::LoadLimb(data) != big_integer_detail::kColumnMagic ||
+            data[big_integer_detail::kLimbBytes] != kBigIntegerFormatVersion) {
+            throw BigIntegerInvalidFormat{};
+        }
+        begin_ += kBigIntegerColumnHeaderLength;
+    }
+
+    Iterator begin() const {
+        return Iterator(begin_, end_);
+    }
+
+    Iterator end() const {
+        return Iterator(end_, end_);
+    }
+};
+
+#endif  // BIG_INTEGER_SERIALIZATION_H
@@ -0,0 +1,124 @@
+#ifndef BIG_INTEGER_SIMD_H
+#define BIG_INTEGER_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+// AVX2 versions of the linear limb kernels. They are compiled with a per-function target attribute
+// and picked at runtime, so the same binary still runs on processors without AVX2.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define BIG_INTEGER_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#else
+#define BIG_INTEGER_HAS_AVX2_KERNELS 0
+#endif
+
+namespace big_integer_detail {
+
+// Shorter arrays are not worth the setup of the vector loop.
+constexpr size_t kSimdMinLimbs = 16;
+
+inline bool HasAvx2() {
+#if BIG_INTEGER_HAS_AVX2_KERNELS
+    static const bool kSupported = __builtin_cpu_supports("avx2") != 0;
+    return kSupported;
+#else
+    return false;
+#endif
+}
+
+#if BIG_INTEGER_HAS_AVX2_KERNELS
+
+// Carries between the 8 lanes of a block are resolved with one scalar addition on lane masks:
+// generate has a bit for every lane that overflows on its own, propagate for every lane that
+// overflows once a carry comes in. (generate << 1) + propagate + carry_in then has the carry chain
+// in its bits, and xor with propagate leaves the carry into each lane.
+
+// r = a + b over size limbs, returns the carry out. r may alias a or b.
+__attribute__((target("avx2"))) inline uint32_t AddNAvx2(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                                                           size_t size) {
+    const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i ones = _mm256_set1_epi32(-1);
+    uint32_t carry = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i sum = _mm256_add_epi32(x, y);
+        // Unsigned sum < x via a signed comparison of both sides shifted by 2^31.
+        __m256i overflow = _mm256_cmpgt_epi32(_mm256_xor_si256(x, sign), _mm256_xor_si256(sum, sign));
+        __m256i saturated = _mm256_cmpeq_epi32(sum, ones);
+        uint32_t generate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(overflow)));
+        uint32_t propagate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(saturated)));
+        uint32_t chain = (generate << 1) + propagate + carry;
+        uint32_t carries = (chain ^ propagate) & 0xFF;
+        carry = chain >> 8;
+        __m256i lanes = _mm256_set1_epi32(static_cast<int>(carries));
+        __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i increment = _mm256_srli_epi32(_mm256_cmpeq_epi32(_mm256_and_si256(lanes, bits), bits), 31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_add_epi32(sum, increment));
+    }
+    for (; i < size; ++i) {
+        uint64_t sum = static_cast<uint64_t>(a[i]) + b[i] + carry;
+        r[i] = static_cast<uint32_t>(sum);
+        carry = static_cast<uint32_t>(sum >> 32);
+    }
+    return carry;
+}
+
+// r = a - b over size limbs, returns the borrow out. r may alias a or b.
+__attribute__((target("avx2"))) inline uint32_t SubNAvx2(uint32_t* r, const uint32_t* a, const uint32_t* b,
+                                                           size_t size) {
+    const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i zero = _mm256_setzero_si256();
+    uint32_t borrow = 0;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        __m256i difference = _mm256_sub_epi32(x, y);
+        __m256i underflow = _mm256_cmpgt_epi32(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+        __m256i empty = _mm256_cmpeq_epi32(difference, zero);
+        uint32_t generate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(underflow)));
+        uint32_t propagate = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(empty)));
+        uint32_t chain = (generate << 1) + propagate + borrow;
+        uint32_t borrows = (chain ^ propagate) & 0xFF;
+        borrow = chain >> 8;
+        __m256i lanes = _mm256_set1_epi32(static_cast<int>(borrows));
+        __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i decrement = _mm256_srli_epi32(_mm256_cmpeq_epi32(_mm256_and_si256(lanes, bits), bits), 31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_sub_epi32(difference, decrement));
+    }
+    for (; i < size; ++i) {
+        uint64_t difference = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+        r[i] = static_cast<uint32_t>(difference);
+        borrow = static_cast<uint32_t>(difference >> 63);
+    }
+    return borrow;
+}
+
+// Three-way comparison of a and b over size limbs, scanning 8 limbs at a time from the top.
+__attribute__((target("avx2"))) inline int CompareAvx2(const uint32_t* a, const uint32_t* b, size_t size) {
+    size_t i = size;
+    for (; i >= 8; i -= 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 8));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 8));
+        uint32_t equal = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y))));
+        if (equal != 0xFF) {
+            size_t lane = 31 - static_cast<size_t>(__builtin_clz(~equal & 0xFF));
+            return (a[i - 8 + lane] < b[i - 8 + lane]) ? -1 : 1;
+        }
+    }
+    for (; i > 0; --i) {
+        if (a[i - 1] != b[i - 1]) {
+            return (a[i - 1] < b[i - 1]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+#endif
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_SIMD_H
@@ -0,0 +1,480 @@
+#ifndef BIG_INTEGER_STATIC_BIG_INTEGER_H
+#define BIG_INTEGER_STATIC_BIG_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+
+#include "big_integer.h"
+
+// BigInteger for constant expressions: the limbs live in a fixed array, every operation is constexpr
+// and runs the portable limb kernels, so constants, tables and moduli are computed by the compiler.
+// Arithmetic follows BigInteger: a value that does not fit the kBlocks limbs, which hold at least
+// NDigits decimal digits, throws BigIntegerOverflow, which in a constant expression is a compile
+// error. Values convert to BigInteger by copying their limbs:
+//
+//     constexpr auto kPrime = 170141183460469231731687303715884105727_big;
+//     constexpr StaticBigInteger<80> kSquare = StaticBigInteger<80>(kPrime) * kPrime;
+//     BigInteger<> modulus = kSquare;
+//
+// The _big literal takes decimal, 0x hexadecimal, 0b binary and 0 octal integer literals with digit
+// separators, its type has just enough digits for the literal. Arithmetic between literals alone
+// happens at that width, so wider results need an explicit type as above.
+template <size_t NDigits>
+class StaticBigInteger {
+public:
+    // Same capacity as BigInteger<NDigits>.
+    static constexpr size_t kBlocks = NDigits * 3322 / 1000 / big_integer_detail::kLimbBits + 2;
+
+private:
+    using Limb = big_integer_detail::Limb;
+    bool negative_;
+    size_t active_blocks_;
+    Limb number_[kBlocks];
+
+    constexpr void Assign(const Limb* limbs, size_t size, bool negative);
+    constexpr void AddSigned(const Limb* other, size_t other_size, bool negative);
+    constexpr void MulAddSmall(Limb factor, Limb addend);
+    static constexpr void DivideModulo(const StaticBigInteger<NDigits>& dividend,
+                                       const StaticBigInteger<NDigits>& divisor, StaticBigInteger<NDigits>* quotient,
+                                       StaticBigInteger<NDigits>* remainder);
+
+public:
+    constexpr StaticBigInteger() : negative_(false), active_blocks_(0), number_{} {
+    }
+    constexpr StaticBigInteger(int num) : StaticBigInteger(static_cast<int64_t>(num)) {  //  NOLINT
+    }
+    constexpr StaticBigInteger(int64_t num);  //  NOLINT
+    constexpr explicit StaticBigInteger(const char* str);
+    // Other widths convert implicitly when they are narrower, explicitly otherwise, throwing
+    // BigIntegerOverflow if the value does not fit.
+    template <size_t NOtherDigits, typename std::enable_if<(NOtherDigits <= NDigits), int>::type = 0>
+    constexpr StaticBigInteger(const StaticBigInteger<NOtherDigits>& other)  //  NOLINT
+        : StaticBigInteger() {
+        Assign(other.Limbs(), other.LimbCount(), other.IsNegative());
+    }
+    template <size_t NOtherDigits, typename std::enable_if<(NOtherDigits > NDigits), int>::type = 0>
+    constexpr explicit StaticBigInteger(const StaticBigInteger<NOtherDigits>& other) : StaticBigInteger() {
+        Assign(other.Limbs(), other.LimbCount(), other.IsNegative());
+    }
+    // Reads length characters with an optional leading sign, in base 10 or a power of two base up to
+    // 32 like BigInteger::FromString.
+    constexpr void FromString(const char* str, size_t length, unsigned base = 10);
+    constexpr bool IsNegative() const {
+        return negative_;
+    }
+    // The normalized magnitude, little-endian.
+    constexpr const Limb* Limbs() const {
+        return number_;
+    }
+    constexpr size_t LimbCount() const {
+        return active_blocks_;
+    }
+    constexpr explicit operator bool() const {
+        return active_blocks_ != 0;
+    }
+    constexpr StaticBigInteger<NDigits> operator+() const {
+        return *this;
+    }
+    constexpr StaticBigInteger<NDigits> operator-() const;
+    constexpr StaticBigInteger<NDigits>& operator+=(const StaticBigInteger<NDigits>& other);
+    constexpr StaticBigInteger<NDigits>& operator-=(const StaticBigInteger<NDigits>& other);
+    constexpr StaticBigInteger<NDigits>& operator*=(const StaticBigInteger<NDigits>& other);
+    constexpr StaticBigInteger<NDigits>& operator/=(const StaticBigInteger<NDigits>& other);
+    constexpr StaticBigInteger<NDigits>& operator%=(const StaticBigInteger<NDigits>& other);
+    // Shifts with the semantics of BigInteger: >>= rounds towards minus infinity.
+    constexpr StaticBigInteger<NDigits>& operator<<=(size_t bits);
+    constexpr StaticBigInteger<NDigits>& operator>>=(size_t bits);
+    constexpr StaticBigInteger<NDigits>& operator++();
+    constexpr StaticBigInteger<NDigits>& operator--();
+    constexpr StaticBigInteger<NDigits> operator++(int);
+    constexpr StaticBigInteger<NDigits> operator--(int);
+
+    // Operators are friends so that either side converts from an integer or a narrower literal.
+    friend constexpr StaticBigInteger<NDigits> operator+(StaticBigInteger<NDigits> first,
+                                                         const StaticBigInteger<NDigits>& second) {
+        return first += second;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator-(StaticBigInteger<NDigits> first,
+                                                         const StaticBigInteger<NDigits>& second) {
+        return first -= second;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator*(StaticBigInteger<NDigits> first,
+                                                         const StaticBigInteger<NDigits>& second) {
+        return first *= second;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator/(StaticBigInteger<NDigits> first,
+                                                         const StaticBigInteger<NDigits>& second) {
+        return first /= second;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator%(StaticBigInteger<NDigits> first,
+                                                         const StaticBigInteger<NDigits>& second) {
+        return first %= second;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator<<(StaticBigInteger<NDigits> first, size_t bits) {
+        return first <<= bits;
+    }
+    friend constexpr StaticBigInteger<NDigits> operator>>(StaticBigInteger<NDigits> first, size_t bits) {
+        return first >>= bits;
+    }
+    // Quotient rounded towards zero and the remainder with the sign of the dividend.
+    friend constexpr std::pair<StaticBigInteger<NDigits>, StaticBigInteger<NDigits>> DivMod(
+        const StaticBigInteger<NDigits>& dividend, const StaticBigInteger<NDigits>& divisor) {
+        std::pair<StaticBigInteger<NDigits>, StaticBigInteger<NDigits>> result;
+        DivideModulo(dividend, divisor, &result.first, &result.second);
+        return result;
+    }
+    // Three-way comparison.
+    friend constexpr int Compare(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        if (first.negative_ != second.negative_) {
+            return first.negative_ ? -1 : 1;
+        }
+        int comparison = big_integer_detail::CompareScalar(first.number_, first.active_blocks_, second.number_,
+                                                           second.active_blocks_);
+        return first.negative_ ? -comparison : comparison;
+    }
+    friend constexpr bool operator==(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) == 0;
+    }
+    friend constexpr bool operator!=(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) != 0;
+    }
+    friend constexpr bool operator<(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) < 0;
+    }
+    friend constexpr bool operator>(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) > 0;
+    }
+    friend constexpr bool operator<=(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) <= 0;
+    }
+    friend constexpr bool operator>=(const StaticBigInteger<NDigits>& first, const StaticBigInteger<NDigits>& second) {
+        return Compare(first, second) >= 0;
+    }
+    friend std::ostream& operator<<(std::ostream& os, const StaticBigInteger<NDigits>& value) {
+        return os << BigInteger<NDigits>(value);
+    }
+};
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>::StaticBigInteger(int64_t num) : StaticBigInteger() {
+    uint64_t magnitude = (num < 0) ? -static_cast<uint64_t>(num) : static_cast<uint64_t>(num);
+    for (; magnitude != 0; magnitude >>= big_integer_detail::kLimbBits) {
+        number_[active_blocks_++] = static_cast<Limb>(magnitude);
+    }
+    negative_ = num < 0;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>::StaticBigInteger(const char* str) : StaticBigInteger() {
+    size_t length = 0;
+    while (str[length] != '\0') {
+        ++length;
+    }
+    FromString(str, length);
+}
+
+template <size_t NDigits>
+constexpr void StaticBigInteger<NDigits>::Assign(const Limb* limbs, size_t size, bool negative) {
+    size = big_integer_detail::Normalize(limbs, size);
+    if (size > kBlocks) {
+        throw BigIntegerOverflow{};
+    }
+    big_integer_detail::Copy(number_, limbs, size);
+    big_integer_detail::Zero(number_ + size, kBlocks - size);
+    active_blocks_ = size;
+    negative_ = negative && size != 0;
+}
+
+template <size_t NDigits>
+constexpr void StaticBigInteger<NDigits>::FromString(const char* str, size_t length, unsigned base) {
+    bool negative = (length > 0 && str[0] == '-');
+    if (length > 0 && (str[0] == '-' || str[0] == '+')) {
+        ++str;
+        --length;
+    }
+    if (base != 10 && big_integer_detail::DigitBits(base) == 0) {
+        throw BigIntegerUnsupportedBase{};
+    }
+    Assign(nullptr, 0, false);
+    for (size_t i = 0; i < length; ++i) {
+        Limb digit = 0;
+        if (base != 10) {
+            digit = big_integer_detail::DigitValue(str[i]) & (base - 1);
+        } else {
+            digit = static_cast<Limb>(str[i] - '0');
+        }
+        MulAddSmall(base, digit);
+    }
+    negative_ = negative && active_blocks_ != 0;
+}
+
+// this = this * factor + addend on the magnitude.
+template <size_t NDigits>
+constexpr void StaticBigInteger<NDigits>::MulAddSmall(Limb factor, Limb addend) {
+    Limb carry = big_integer_detail::Mul1(number_, number_, active_blocks_, factor, addend);
+    if (carry != 0) {
+        if (active_blocks_ == kBlocks) {
+            throw BigIntegerOverflow{};
+        }
+        number_[active_blocks_++] = carry;
+    }
+}
+
+// this += (negative ? -other : other) for a normalized other that is not a part of this.
+template <size_t NDigits>
+constexpr void StaticBigInteger<NDigits>::AddSigned(const Limb* other, size_t other_size, bool negative) {
+    if (other_size == 0) {
+        return;
+    }
+    if (negative_ == negative || active_blocks_ == 0) {
+        size_t size = (active_blocks_ > other_size) ? active_blocks_ : other_size;
+        // The limbs past active_blocks_ are zero, so the sum runs over size limbs of both.
+        Limb carry = big_integer_detail::AddNScalar(number_, number_, other, other_size);
+        carry = big_integer_detail::AddCarry(number_ + other_size, number_ + other_size, size - other_size, carry);
+        active_blocks_ = size;
+        if (carry != 0) {
+            if (size == kBlocks) {
+                throw BigIntegerOverflow{};
+            }
+            number_[active_blocks_++] = carry;
+        }
+        negative_ = negative;
+        return;
+    }
+    int comparison = big_integer_detail::CompareScalar(number_, active_blocks_, other, other_size);
+    if (comparison == 0) {
+        Assign(nullptr, 0, false);
+        return;
+    }
+    if (comparison > 0) {
+        Limb borrow = big_integer_detail::SubNScalar(number_, number_, other, other_size);
+        big_integer_detail::SubBorrow(number_ + other_size, number_ + other_size, active_blocks_ - other_size, borrow);
+    } else {
+        // |this| < |other|: the result is other - |this| with the sign of other.
+        big_integer_detail::SubNScalar(number_, other, number_, other_size);
+        negative_ = negative;
+        active_blocks_ = other_size;
+    }
+    active_blocks_ = big_integer_detail::Normalize(number_, active_blocks_);
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits> StaticBigInteger<NDigits>::operator-() const {
+    StaticBigInteger<NDigits> result(*this);
+    result.negative_ = !negative_ && active_blocks_ != 0;
+    return result;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator+=(const StaticBigInteger<NDigits>& other) {
+    if (this == &other) {
+        StaticBigInteger<NDigits> copy(other);
+        AddSigned(copy.number_, copy.active_blocks_, copy.negative_);
+    } else {
+        AddSigned(other.number_, other.active_blocks_, other.negative_);
+    }
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator-=(const StaticBigInteger<NDigits>& other) {
+    if (this == &other) {
+        Assign(nullptr, 0, false);
+    } else {
+        AddSigned(other.number_, other.active_blocks_, !other.negative_);
+    }
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator*=(const StaticBigInteger<NDigits>& other) {
+    if (active_blocks_ == 0 || other.active_blocks_ == 0) {
+        Assign(nullptr, 0, false);
+        return *this;
+    }
+    Limb product[2 * kBlocks] = {};
+    big_integer_detail::MulSchoolbook(product, number_, active_blocks_, other.number_, other.active_blocks_);
+    Assign(product, active_blocks_ + other.active_blocks_, negative_ != other.negative_);
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr void StaticBigInteger<NDigits>::DivideModulo(const StaticBigInteger<NDigits>& dividend,
+                                                       const StaticBigInteger<NDigits>& divisor,
+                                                       StaticBigInteger<NDigits>* quotient,
+                                                       StaticBigInteger<NDigits>* remainder) {
+    size_t a_size = dividend.active_blocks_;
+    size_t b_size = divisor.active_blocks_;
+    if (b_size == 0) {
+        throw BigIntegerDivisionByZero{};
+    }
+    if (big_integer_detail::CompareScalar(dividend.number_, a_size, divisor.number_, b_size) < 0) {
+        StaticBigInteger<NDigits> rest(dividend);
+        quotient->Assign(nullptr, 0, false);
+        *remainder = rest;
+        return;
+    }
+    // Knuth's Algorithm D on copies shifted so that the top bit of the divisor is set.
+    size_t shift = big_integer_detail::CountLeadingZeros(divisor.number_[b_size - 1]);
+    Limb u[kBlocks + 1] = {};
+    Limb d[kBlocks] = {};
+    Limb q[kBlocks] = {};
+    u[a_size] = big_integer_detail::ShiftLeft(u, dividend.number_, a_size, shift);
+    big_integer_detail::ShiftLeft(d, divisor.number_, b_size, shift);
+    big_integer_detail::DivModSchoolbook(q, u, a_size, d, b_size);
+    big_integer_detail::ShiftRight(u, u, b_size, shift);
+    bool quotient_negative = dividend.negative_ != divisor.negative_;
+    bool remainder_negative = dividend.negative_;
+    quotient->Assign(q, a_size - b_size + 1, quotient_negative);
+    remainder->Assign(u, b_size, remainder_negative);
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator/=(const StaticBigInteger<NDigits>& other) {
+    StaticBigInteger<NDigits> remainder;
+    DivideModulo(*this, other, this, &remainder);
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator%=(const StaticBigInteger<NDigits>& other) {
+    StaticBigInteger<NDigits> quotient;
+    DivideModulo(*this, other, &quotient, this);
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator<<=(size_t bits) {
+    if (active_blocks_ == 0) {
+        return *this;
+    }
+    size_t words = bits / big_integer_detail::kLimbBits;
+    if (words >= kBlocks) {
+        throw BigIntegerOverflow{};
+    }
+    Limb shifted[kBlocks + 1] = {};
+    shifted[active_blocks_] =
+        big_integer_detail::ShiftLeft(shifted, number_, active_blocks_, bits % big_integer_detail::kLimbBits);
+    size_t size = big_integer_detail::Normalize(shifted, active_blocks_ + 1);
+    if (size + words > kBlocks) {
+        throw BigIntegerOverflow{};
+    }
+    big_integer_detail::Zero(number_, words);
+    big_integer_detail::Copy(number_ + words, shifted, size);
+    active_blocks_ = size + words;
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator>>=(size_t bits) {
+    size_t words = bits / big_integer_detail::kLimbBits;
+    if (words >= active_blocks_) {
+        *this = StaticBigInteger<NDigits>(negative_ ? -1 : 0);
+        return *this;
+    }
+    bool inexact = false;
+    for (size_t i = 0; i < words; ++i) {
+        inexact = inexact || number_[i] != 0;
+    }
+    size_t size = active_blocks_ - words;
+    Limb out = big_integer_detail::ShiftRight(number_, number_ + words, size, bits % big_integer_detail::kLimbBits);
+    inexact = inexact || out != 0;
+    big_integer_detail::Zero(number_ + size, active_blocks_ - size);
+    active_blocks_ = big_integer_detail::Normalize(number_, size);
+    if (negative_ && inexact) {
+        Limb one[1] = {1};
+        AddSigned(one, 1, true);
+    }
+    negative_ = negative_ && active_blocks_ != 0;
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator++() {
+    Limb one[1] = {1};
+    AddSigned(one, 1, false);
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits>& StaticBigInteger<NDigits>::operator--() {
+    Limb one[1] = {1};
+    AddSigned(one, 1, true);
+    return *this;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits> StaticBigInteger<NDigits>::operator++(int) {
+    StaticBigInteger<NDigits> previous(*this);
+    ++*this;
+    return previous;
+}
+
+template <size_t NDigits>
+constexpr StaticBigInteger<NDigits> StaticBigInteger<NDigits>::operator--(int) {
+    StaticBigInteger<NDigits> previous(*this);
+    --*this;
+    return previous;
+}
+
+namespace big_integer_detail {
+
+// Base of an integer literal from its prefix, with the length of the prefix.
+constexpr unsigned LiteralBase(const char* text, size_t length, size_t* prefix) {
+    *prefix = 0;
+    if (length > 1 && text[0] == '0') {
+        if (text[1] == 'x' || text[1] == 'X') {
+            *prefix = 2;
+            return 16;
+        }
+        if (text[1] == 'b' || text[1] == 'B') {
+            *prefix = 2;
+            return 2;
+        }
+        *prefix = 1;
+        return 8;
+    }
+    return 10;
+}
+
+// Decimal digits enough for the value of an integer literal: log10 of 2, 8 and 16 are below 0.302,
+// 0.904 and 1.205.
+template <char... Chars>
+constexpr size_t LiteralDigits() {
+    const char text[] = {Chars...};
+    size_t prefix = 0;
+    unsigned base = LiteralBase(text, sizeof...(Chars), &prefix);
+    size_t digits = 0;
+    for (size_t i = prefix; i < sizeof...(Chars); ++i) {
+        digits += (text[i] != '\'') ? 1 : 0;
+    }
+    if (base == 10) {
+        return digits;
+    }
+    size_t per_mille = (base == 2) ? 302 : (base == 8) ? 904 : 1205;
+    return digits * per_mille / 1000 + 1;
+}
+
+}  // namespace big_integer_detail
+
+template <char... Chars>
+constexpr StaticBigInteger<big_integer_detail::LiteralDigits<Chars...>()> operator""_big() {
+    const char text[] = {Chars...};
+    size_t prefix = 0;
+    unsigned base = big_integer_detail::LiteralBase(text, sizeof...(Chars), &prefix);
+    char digits[sizeof...(Chars)] = {};
+    size_t length = 0;
+    for (size_t i = prefix; i < sizeof...(Chars); ++i) {
+        if (text[i] != '\'') {
+            digits[length++] = text[i];
+        }
+    }
+    StaticBigInteger<big_integer_detail::LiteralDigits<Chars...>()> result;
+    result.FromString(digits, length, base);
+    return result;
+}
+
+#endif  // BIG_INTEGER_STATIC_BIG_INTEGER_H
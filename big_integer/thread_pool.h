@@ -0,0 +1,187 @@
+#ifndef BIG_INTEGER_THREAD_POOL_H
+#define BIG_INTEGER_THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace big_integer_detail {
+
+// Work-stealing pool for fork-join parallelism. Every worker has its own deque: it pushes and pops
+// its own tasks at the back and steals from the front of the others when it runs dry. A thread
+// waiting for its tasks keeps running queued ones, so nested Run calls never block a worker.
+class ThreadPool {
+private:
+    struct Group {
+        std::atomic<size_t> pending;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        const std::function<void(size_t)>* function;
+        size_t index;
+        Group* group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Queue 0 takes tasks from threads outside the pool, queue i + 1 belongs to worker i.
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_{false};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_up_;
+
+    ThreadPool() = default;
+
+    static size_t& QueueIndex() {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    void Push(const Task& task) {
+        Queue& queue = *queues_[QueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        wake_up_.notify_one();
+    }
+
+    bool TryPop(Task* task) {
+        size_t own = QueueIndex();
+        {
+            Queue& queue = *queues_[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                *task = queue.tasks.back();
+                queue.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i <= queues_.size(); ++i) {
+            Queue& queue = *queues_[(own + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                *task = queue.tasks.front();
+                queue.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void Execute(const Task& task) {
+        try {
+            (*task.function)(task.index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(task.group->error_mutex);
+            if (!task.group->error) {
+                task.group->error = std::current_exception();
+            }
+        }
+        task.group->pending.fetch_sub(1);
+    }
+
+    void WorkerLoop(size_t index) {
+        QueueIndex() = index;
+        Task task;
+        while (!stopping_.load()) {
+            if (TryPop(&task)) {
+                Execute(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_up_.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    void Stop() {
+        stopping_.store(true);
+        wake_up_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+        queues_.clear();
+        stopping_.store(false);
+    }
+
+public:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        Stop();
+    }
+
+    static ThreadPool& Instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Number of worker threads, 0 runs everything on the calling thread. Must not be called while
+    // tasks are running.
+    void SetThreadCount(size_t threads) {
+        Stop();
+        for (size_t i = 0; i <= threads; ++i) {
+            queues_.emplace_back(new Queue());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back(&ThreadPool::WorkerLoop, this, i + 1);
+        }
+    }
+
+    size_t ThreadCount() const {
+        return workers_.size();
+    }
+
+    // Calls function(i) for every i < count and returns once all calls are done. The first exception
+    // thrown by a call is rethrown here.
+    void Run(size_t count, const std::function<void(size_t)>& function) {
+        if (workers_.empty() || count < 2) {
+            for (size_t i = 0; i < count; ++i) {
+                function(i);
+            }
+            return;
+        }
+        Group group;
+        group.pending.store(count - 1);
+        for (size_t i = count - 1; i > 0; --i) {
+            Push(Task{&function, i, &group});
+        }
+        Group own;
+        own.pending.store(1);
+        Execute(Task{&function, 0, &own});
+        Task task;
+        while (group.pending.load() != 0) {
+            if (TryPop(&task)) {
+                Execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        if (own.error) {
+            std::rethrow_exception(own.error);
+        }
+        if (group.error) {
+            std::rethrow_exception(group.error);
+        }
+    }
+};
+
+}  // namespace big_integer_detail
+
+#endif  // BIG_INTEGER_THREAD_POOL_H
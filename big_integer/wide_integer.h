@@ -0,0 +1,460 @@
+#ifndef BIG_INTEGER_WIDE_INTEGER_H
+#define BIG_INTEGER_WIDE_INTEGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "big_integer.h"
+
+// What fixed-width arithmetic does with results that do not fit: kWrap reduces them modulo 2^NBits
+// like the built-in unsigned types, kChecked throws BigIntegerOverflow.
+enum class BigIntegerOverflowMode { kWrap, kChecked };
+
+// Fixed-width integer of NBits bits in two's complement, signed or unsigned. It is a plain array of
+// limbs on the stack, trivially copyable, and every operation is a constexpr loop over the constant
+// number of limbs that the compiler unrolls, so widths of a few hundred bits run close to built-in
+// integers. The interface follows BigInteger: arithmetic with division rounding towards zero, shifts
+// with >> rounding towards minus infinity, bitwise operations, comparisons, string and stream I/O
+// and explicit conversions from and to BigInteger. Integers convert implicitly under the rules of
+// the mode, so in kChecked mode UInt<256>(-1) throws.
+//
+//     UInt<256> hash = ...;
+//     Int<512, BigIntegerOverflowMode::kChecked> total = Int<512, BigIntegerOverflowMode::kChecked>(hash) * 3;
+template <size_t NBits, bool NSigned, BigIntegerOverflowMode NMode = BigIntegerOverflowMode::kWrap>
+class WideInteger {
+    static_assert(NBits > 0 && NBits % big_integer_detail::kLimbBits == 0,
+                  "the width must be a positive multiple of the limb width");
+
+public:
+    using Limb = big_integer_detail::Limb;
+    static constexpr size_t kLimbs = NBits / big_integer_detail::kLimbBits;
+    // Decimal digits enough for any value, log10(2) < 0.302.
+    static constexpr size_t kDigits = NBits * 302 / 1000 + 2;
+
+private:
+    static constexpr bool kChecked = NMode == BigIntegerOverflowMode::kChecked;
+    static constexpr Limb kSignBit = static_cast<Limb>(1) << (big_integer_detail::kLimbBits - 1);
+    Limb limbs_[kLimbs];
+
+    static constexpr void CheckOverflow(bool overflow) {
+        if (kChecked && overflow) {
+            throw BigIntegerOverflow{};
+        }
+    }
+
+    static constexpr void Negate(Limb* a, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            a[i] = ~a[i];
+        }
+        big_integer_detail::AddCarry(a, a, size, 1);
+    }
+
+    // Whether the top bit is set, for unsigned values as well.
+    constexpr bool TopBit() const {
+        return (limbs_[kLimbs - 1] & kSignBit) != 0;
+    }
+
+    // The limb that extends the value to the left: all ones for negative values.
+    constexpr Limb Fill() const {
+        return (NSigned && TopBit()) ? ~static_cast<Limb>(0) : 0;
+    }
+
+    // this = the two's complement number of count limbs extended to the left by copies of fill,
+    // truncated to NBits. With check, a number that does not fit throws BigIntegerOverflow.
+    constexpr void Assign(const Limb* limbs, size_t count, Limb fill, bool check) {
+        bool fits = true;
+        for (size_t i = 0; i < kLimbs; ++i) {
+            limbs_[i] = (i < count) ? limbs[i] : fill;
+        }
+        for (size_t i = kLimbs; i < count; ++i) {
+            fits = fits && limbs[i] == fill;
+        }
+        fits = fits && (NSigned ? TopBit() == (fill != 0) : fill == 0);
+        if (check && !fits) {
+            throw BigIntegerOverflow{};
+        }
+    }
+
+    // The magnitude as an unsigned kLimbs-limb number, which holds it even for the most negative value.
+    constexpr bool Magnitude(Limb* magnitude) const {
+        big_integer_detail::Copy(magnitude, limbs_, kLimbs);
+        bool negative = NSigned && TopBit();
+        if (negative) {
+            Negate(magnitude, kLimbs);
+        }
+        return negative;
+    }
+
+    // this = (negative ? -magnitude : magnitude), magnitude has kLimbs limbs and the result must fit.
+    constexpr void AssignMagnitude(const Limb* magnitude, bool negative) {
+        big_integer_detail::Copy(limbs_, magnitude, kLimbs);
+        if (negative) {
+            Negate(limbs_, kLimbs);
+        }
+    }
+
+    constexpr bool IsMostNegative() const {
+        if (!NSigned || limbs_[kLimbs - 1] != kSignBit) {
+            return false;
+        }
+        for (size_t i = 0; i + 1 < kLimbs; ++i) {
+            if (limbs_[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // quotient may be nullptr when only the remainder is needed.
+    static constexpr void DivideModulo(const WideInteger& dividend, const WideInteger& divisor, WideInteger* quotient,
+                                       WideInteger* remainder) {
+        Limb a[kLimbs] = {};
+        Limb b[kLimbs] = {};
+        bool a_negative = dividend.Magnitude(a);
+        bool b_negative = divisor.Magnitude(b);
+        size_t a_size = big_integer_detail::Normalize(a, kLimbs);
+        size_t b_size = big_integer_detail::Normalize(b, kLimbs);
+        if (b_size == 0) {
+            throw BigIntegerDivisionByZero{};
+        }
+        Limb q[kLimbs] = {};
+        Limb r[kLimbs] = {};
+        if (big_integer_detail::CompareScalar(a, a_size, b, b_size) < 0) {
+            big_integer_detail::Copy(r, a, a_size);
+        } else {
+            size_t shift = big_integer_detail::CountLeadingZeros(b[b_size - 1]);
+            Limb u[kLimbs + 1] = {};
+            Limb d[kLimbs] = {};
+            u[a_size] = big_integer_detail::ShiftLeft(u, a, a_size, shift);
+            big_integer_detail::ShiftLeft(d, b, b_size, shift);
+            big_integer_detail::DivModSchoolbook(q, u, a_size, d, b_size);
+            big_integer_detail::ShiftRight(r, u, b_size, shift);
+        }
+        bool quotient_negative = a_negative != b_negative;
+        if (quotient != nullptr) {
+            // Only the most negative value divided by -1 leaves the range.
+            CheckOverflow(NSigned && !quotient_negative && (q[kLimbs - 1] & kSignBit) != 0);
+            quotient->AssignMagnitude(q, quotient_negative);
+        }
+        remainder->AssignMagnitude(r, a_negative);
+    }
+
+public:
+    constexpr WideInteger() : limbs_{} {
+    }
+    template <class Integer, typename std::enable_if<std::is_integral<Integer>::value, int>::type = 0>
+    constexpr WideInteger(Integer num) : limbs_{} {  //  NOLINT
+        uint64_t bits = static_cast<uint64_t>(num);
+        Limb source[2] = {static_cast<Limb>(bits), static_cast<Limb>(bits >> big_integer_detail::kLimbBits)};
+        bool negative = std::is_signed<Integer>::value && (bits >> 63) != 0;
+        Assign(source, 2, negative ? ~static_cast<Limb>(0) : 0, kChecked);
+    }
+    // Other widths, signedness and modes convert under the rules of this mode.
+    template <size_t NOtherBits, bool NOtherSigned, BigIntegerOverflowMode NOtherMode>
+    constexpr explicit WideInteger(const WideInteger<NOtherBits, NOtherSigned, NOtherMode>& other) : limbs_{} {
+        Limb fill = (NOtherSigned && other.IsNegative()) ? ~static_cast<Limb>(0) : 0;
+        Assign(other.Limbs(), WideInteger<NOtherBits, NOtherSigned, NOtherMode>::kLimbs, fill, kChecked);
+    }
+    template <size_t NDigits>
+    explicit WideInteger(const BigInteger<NDigits>& value) : limbs_{} {
+        std::vector<uint8_t> bytes(value.ByteLength());
+        value.ToBytes(bytes.data(), BigIntegerByteOrder::kLittleEndian);
+        std::vector<Limb> magnitude(bytes.size() / big_integer_detail::kLimbBytes + 2);
+        big_integer_detail::FromBytes(magnitude.data(), bytes.data(), bytes.size(), BigIntegerByteOrder::kLittleEndian);
+        if (value.IsNegative()) {
+            Negate(magnitude.data(), magnitude.size());
+        }
+        Assign(magnitude.data(), magnitude.size(), value.IsNegative() ? ~static_cast<Limb>(0) : 0, kChecked);
+    }
+    template <size_t NDigits>
+    explicit operator BigInteger<NDigits>() const {
+        Limb magnitude[kLimbs] = {};
+        bool negative = Magnitude(magnitude);
+        uint8_t bytes[kLimbs * big_integer_detail::kLimbBytes] = {};
+        big_integer_detail::ToBytes(bytes, sizeof(bytes), magnitude, kLimbs, BigIntegerByteOrder::kLittleEndian);
+        BigInteger<NDigits> result;
+        result.FromBytes(bytes, sizeof(bytes), BigIntegerByteOrder::kLittleEndian);
+        return negative ? -result : result;
+    }
+
+    // The kLimbs limbs of the two's complement representation, least significant first.
+    constexpr const Limb* Limbs() const {
+        return limbs_;
+    }
+    constexpr bool IsNegative() const {
+        return NSigned && TopBit();
+    }
+    constexpr explicit operator bool() const {
+        for (size_t i = 0; i < kLimbs; ++i) {
+            if (limbs_[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    // Bits of the magnitude, 0 for zero.
+    constexpr size_t BitLength() const {
+        Limb magnitude[kLimbs] = {};
+        Magnitude(magnitude);
+        size_t size = big_integer_detail::Normalize(magnitude, kLimbs);
+        return (size == 0) ? 0
+                           : size * big_integer_detail::kLimbBits -
+                                 big_integer_detail::CountLeadingZeros(magnitude[size - 1]);
+    }
+    // Set bits of the magnitude.
+    constexpr size_t PopCount() const {
+        Limb magnitude[kLimbs] = {};
+        Magnitude(magnitude);
+        size_t count = 0;
+        for (size_t i = 0; i < kLimbs; ++i) {
+            for (Limb value = magnitude[i]; value != 0; value &= value - 1) {
+                ++count;
+            }
+        }
+        return count;
+    }
+    // Bit of the two's complement representation, bits past the width repeat the sign.
+    constexpr bool TestBit(size_t bit) const {
+        if (bit >= NBits) {
+            return IsNegative();
+        }
+        return ((limbs_[bit / big_integer_detail::kLimbBits] >> (bit % big_integer_detail::kLimbBits)) & 1) != 0;
+    }
+
+    constexpr WideInteger operator+() const {
+        return *this;
+    }
+    constexpr WideInteger operator-() const {
+        CheckOverflow(NSigned ? IsMostNegative() : static_cast<bool>(*this));
+        WideInteger result(*this);
+        Negate(result.limbs_, kLimbs);
+        return result;
+    }
+    constexpr WideInteger operator~() const {
+        WideInteger result;
+        for (size_t i = 0; i < kLimbs; ++i) {
+            result.limbs_[i] = ~limbs_[i];
+        }
+        return result;
+    }
+    // In kChecked mode an operation that throws leaves the value unchanged.
+    constexpr WideInteger& operator+=(const WideInteger& other) {
+        WideInteger sum;
+        Limb carry = big_integer_detail::AddNScalar(sum.limbs_, limbs_, other.limbs_, kLimbs);
+        CheckOverflow(NSigned ? (TopBit() == other.TopBit() && sum.TopBit() != TopBit()) : carry != 0);
+        return *this = sum;
+    }
+    constexpr WideInteger& operator-=(const WideInteger& other) {
+        WideInteger difference;
+        Limb borrow = big_integer_detail::SubNScalar(difference.limbs_, limbs_, other.limbs_, kLimbs);
+        CheckOverflow(NSigned ? (TopBit() != other.TopBit() && difference.TopBit() != TopBit()) : borrow != 0);
+        return *this = difference;
+    }
+    constexpr WideInteger& operator*=(const WideInteger& other) {
+        if (!kChecked) {
+            // The low half of the product is the same for signed and unsigned operands.
+            Limb product[kLimbs] = {};
+            for (size_t i = 0; i < kLimbs; ++i) {
+                big_integer_detail::AddMul1(product + i, limbs_, kLimbs - i, other.limbs_[i]);
+            }
+            big_integer_detail::Copy(limbs_, product, kLimbs);
+            return *this;
+        }
+        Limb first[kLimbs] = {};
+        Limb second[kLimbs] = {};
+        bool negative = Magnitude(first) != other.Magnitude(second);
+        Limb product[2 * kLimbs] = {};
+        big_integer_detail::MulSchoolbook(product, first, kLimbs, second, kLimbs);
+        WideInteger result;
+        result.AssignMagnitude(product, negative);
+        // A signed magnitude may reach 2^(NBits - 1) only for a negative result.
+        CheckOverflow(big_integer_detail::Normalize(product, 2 * kLimbs) > kLimbs ||
+                      (NSigned && (product[kLimbs - 1] & kSignBit) != 0 && !(negative && result.IsMostNegative())));
+        return *this = result;
+    }
+    constexpr WideInteger& operator/=(const WideInteger& other) {
+        WideInteger remainder;
+        DivideModulo(*this, other, this, &remainder);
+        return *this;
+    }
+    constexpr WideInteger& operator%=(const WideInteger& other) {
+        DivideModulo(*this, other, nullptr, this);
+        return *this;
+    }
+    constexpr WideInteger& operator&=(const WideInteger& other) {
+        for (size_t i = 0; i < kLimbs; ++i) {
+            limbs_[i] &= other.limbs_[i];
+        }
+        return *this;
+    }
+    constexpr WideInteger& operator|=(const WideInteger& other) {
+        for (size_t i = 0; i < kLimbs; ++i) {
+            limbs_[i] |= other.limbs_[i];
+        }
+        return *this;
+    }
+    constexpr WideInteger& operator^=(const WideInteger& other) {
+        for (size_t i = 0; i < kLimbs; ++i) {
+            limbs_[i] ^= other.limbs_[i];
+        }
+        return *this;
+    }
+    // Bits shifted past the width are lost in kWrap mode and overflow in kChecked mode.
+    constexpr WideInteger& operator<<=(size_t bits) {
+        WideInteger shifted;
+        if (bits < NBits) {
+            size_t words = bits / big_integer_detail::kLimbBits;
+            big_integer_detail::ShiftLeft(shifted.limbs_ + words, limbs_, kLimbs - words,
+                                          bits % big_integer_detail::kLimbBits);
+        }
+        if (kChecked) {
+            // Nothing was lost if shifting back restores the value.
+            WideInteger back(shifted);
+            back >>= (bits < NBits) ? bits : NBits;
+            CheckOverflow(back != *this || (bits >= NBits && static_cast<bool>(*this)));
+        }
+        return *this = shifted;
+    }
+    // Arithmetic for signed values, so negative values round towards minus infinity.
+    constexpr WideInteger& operator>>=(size_t bits) {
+        Limb fill = Fill();
+        size_t words = (bits < NBits) ? bits / big_integer_detail::kLimbBits : kLimbs;
+        Limb extended[kLimbs + 1] = {};
+        for (size_t i = 0; i <= kLimbs; ++i) {
+            extended[i] = (i + words < kLimbs) ? limbs_[i + words] : fill;
+        }
+        if (words < kLimbs) {
+            big_integer_detail::ShiftRight(extended, extended, kLimbs + 1, bits % big_integer_detail::kLimbBits);
+        }
+        big_integer_detail::Copy(limbs_, extended, kLimbs);
+        return *this;
+    }
+    constexpr WideInteger& operator++() {
+        WideInteger next;
+        Limb carry = big_integer_detail::AddCarry(next.limbs_, limbs_, kLimbs, 1);
+        CheckOverflow(NSigned ? (!TopBit() && next.TopBit()) : carry != 0);
+        return *this = next;
+    }
+    constexpr WideInteger& operator--() {
+        WideInteger next;
+        Limb borrow = big_integer_detail::SubBorrow(next.limbs_, limbs_, kLimbs, 1);
+        CheckOverflow(NSigned ? (TopBit() && !next.TopBit()) : borrow != 0);
+        return *this = next;
+    }
+    constexpr WideInteger operator++(int) {
+        WideInteger previous(*this);
+        ++*this;
+        return previous;
+    }
+    constexpr WideInteger operator--(int) {
+        WideInteger previous(*this);
+        --*this;
+        return previous;
+    }
+
+    // Reads length characters with an optional leading sign in base 10 or a power of two base up to
+    // 32, like BigInteger::FromString. Values out of range throw BigIntegerOverflow in either mode.
+    void FromString(const char* str, size_t length, unsigned base = 10) {
+        BigInteger<kDigits> value;
+        value.FromString(str, length, base);
+        WideInteger<NBits, NSigned, BigIntegerOverflowMode::kChecked> checked(value);
+        big_integer_detail::Copy(limbs_, checked.Limbs(), kLimbs);
+    }
+    size_t MaxStringLength(unsigned base = 10) const {
+        return static_cast<BigInteger<kDigits>>(*this).MaxStringLength(base);
+    }
+    size_t ToString(char* buffer, unsigned base = 10) const {
+        return static_cast<BigInteger<kDigits>>(*this).ToString(buffer, base);
+    }
+    friend std::istream& operator>>(std::istream& is, WideInteger& value) {
+        BigInteger<kDigits> read;
+        if (is >> read) {
+            value = WideInteger(WideInteger<NBits, NSigned, BigIntegerOverflowMode::kChecked>(read));
+        }
+        return is;
+    }
+    friend std::ostream& operator<<(std::ostream& os, const WideInteger& value) {
+        return os << static_cast<BigInteger<kDigits>>(value);
+    }
+
+    // Operators are friends so that either side converts from a built-in integer.
+    friend constexpr WideInteger operator+(WideInteger first, const WideInteger& second) {
+        return first += second;
+    }
+    friend constexpr WideInteger operator-(WideInteger first, const WideInteger& second) {
+        return first -= second;
+    }
+    friend constexpr WideInteger operator*(WideInteger first, const WideInteger& second) {
+        return first *= second;
+    }
+    friend constexpr WideInteger operator/(WideInteger first, const WideInteger& second) {
+        return first /= second;
+    }
+    friend constexpr WideInteger operator%(WideInteger first, const WideInteger& second) {
+        return first %= second;
+    }
+    friend constexpr WideInteger operator&(WideInteger first, const WideInteger& second) {
+        return first &= second;
+    }
+    friend constexpr WideInteger operator|(WideInteger first, const WideInteger& second) {
+        return first |= second;
+    }
+    friend constexpr WideInteger operator^(WideInteger first, const WideInteger& second) {
+        return first ^= second;
+    }
+    friend constexpr WideInteger operator<<(WideInteger first, size_t bits) {
+        return first <<= bits;
+    }
+    friend constexpr WideInteger operator>>(WideInteger first, size_t bits) {
+        return first >>= bits;
+    }
+    // Quotient rounded towards zero and the remainder with the sign of the dividend.
+    friend constexpr std::pair<WideInteger, WideInteger> DivMod(const WideInteger& dividend,
+                                                                const WideInteger& divisor) {
+        std::pair<WideInteger, WideInteger> result;
+        DivideModulo(dividend, divisor, &result.first, &result.second);
+        return result;
+    }
+    // Three-way comparison, the top limb of signed values compares with its sign bit flipped.
+    friend constexpr int Compare(const WideInteger& first, const WideInteger& second) {
+        for (size_t i = kLimbs; i > 0; --i) {
+            Limb flip = (NSigned && i == kLimbs) ? kSignBit : 0;
+            Limb a = first.limbs_[i - 1] ^ flip;
+            Limb b = second.limbs_[i - 1] ^ flip;
+            if (a != b) {
+                return (a < b) ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+    friend constexpr bool operator==(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) == 0;
+    }
+    friend constexpr bool operator!=(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) != 0;
+    }
+    friend constexpr bool operator<(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) < 0;
+    }
+    friend constexpr bool operator>(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) > 0;
+    }
+    friend constexpr bool operator<=(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) <= 0;
+    }
+    friend constexpr bool operator>=(const WideInteger& first, const WideInteger& second) {
+        return Compare(first, second) >= 0;
+    }
+};
+
+template <size_t NBits, BigIntegerOverflowMode NMode = BigIntegerOverflowMode::kWrap>
+using UInt = WideInteger<NBits, false, NMode>;
+
+template <size_t NBits, BigIntegerOverflowMode NMode = BigIntegerOverflowMode::kWrap>
+using Int = WideInteger<NBits, true, NMode>;
+
+#endif  // BIG_INTEGER_WIDE_INTEGER_H
@@ -3,6 +3,8 @@
 
 #include "cstddef"
 #include <iostream>
+#include <memory>
+#include <new>
 
 template <class T>
 void Swap(T &first, T &second) {
@@ -27,21 +29,29 @@ void Copy(T *buffer_to, const T *buffer_from, const size_t capacity, const size_
     }
 }
 
-template <class T>
+template <class T, class Allocator = std::allocator<T>>
 class CircularBuffer {
 private:
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+    // Every one of the capacity_ slots holds an object, so that PopBack and PopFront can hand out
+    // references to the slots they leave.
     T *buffer_;
     const static size_t kIncreaseFactor = 2;
     size_t capacity_;
     size_t head_;
     size_t tail_;
     size_t size_;
+    Allocator allocator_;
+
+    T *Allocate(const size_t capacity);
+    void Deallocate(T *buffer, const size_t capacity);
 
 public:
     CircularBuffer();
-    explicit CircularBuffer(const size_t size);  //  NOLINT
-    CircularBuffer(const CircularBuffer<T> &other);
-    CircularBuffer<T> &operator=(const CircularBuffer<T> &other);
+    explicit CircularBuffer(const Allocator &allocator);
+    explicit CircularBuffer(const size_t size, const Allocator &allocator = Allocator());  //  NOLINT
+    CircularBuffer(const CircularBuffer<T, Allocator> &other);
+    CircularBuffer<T, Allocator> &operator=(const CircularBuffer<T, Allocator> &other);
     ~CircularBuffer();
     const T &operator[](size_t idx) const;
     T &operator[](size_t idx);
@@ -58,30 +68,81 @@ public:
     T &PopFront();
     void Clear();
     void Reserve(const size_t new_capacity);
-    void Swap(CircularBuffer<T> &other);
+    // Swaps the allocators too if they propagate on swap, otherwise they must be equal.
+    void Swap(CircularBuffer<T, Allocator> &other);
+    Allocator GetAllocator() const;
     size_t IncreaseCapacity() const;
     void BufferReallocation(const size_t new_capacity, bool needs_copy);
 };
 
-template <class T>
-CircularBuffer<T>::CircularBuffer() : buffer_(nullptr), capacity_(0), head_(0), tail_(0), size_(0) {
+// Default-initializes every slot like new T[capacity] did.
+template <class T, class Allocator>
+T *CircularBuffer<T, Allocator>::Allocate(const size_t capacity) {
+    if (capacity == 0) {
+        return nullptr;
+    }
+    T *buffer = AllocatorTraits::allocate(allocator_, capacity);
+    size_t i = 0;
+    try {
+        for (; i < capacity; ++i) {
+            ::new (static_cast<void *>(buffer + i)) T;
+        }
+    } catch (...) {
+        for (; i > 0; --i) {
+            buffer[i - 1].~T();
+        }
+        AllocatorTraits::deallocate(allocator_, buffer, capacity);
+        throw;
+    }
+    return buffer;
 }
 
-template <class T>
-CircularBuffer<T>::CircularBuffer(const size_t capacity) : capacity_(capacity), head_(0), tail_(0), size_(0) {
-    buffer_ = new T[capacity_];
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::Deallocate(T *buffer, const size_t capacity) {
+    if (buffer == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        buffer[i].~T();
+    }
+    AllocatorTraits::deallocate(allocator_, buffer, capacity);
 }
 
-template <class T>
-CircularBuffer<T>::CircularBuffer(const CircularBuffer<T> &other)
-    : capacity_(other.capacity_), head_(0), tail_(other.Size()), size_(other.size_) {
-    buffer_ = new T[capacity_];
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer() : buffer_(nullptr), capacity_(0), head_(0), tail_(0), size_(0) {
+}
+
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const Allocator &allocator)
+    : buffer_(nullptr), capacity_(0), head_(0), tail_(0), size_(0), allocator_(allocator) {
+}
+
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const size_t capacity, const Allocator &allocator)
+    : capacity_(capacity), head_(0), tail_(0), size_(0), allocator_(allocator) {
+    buffer_ = Allocate(capacity_);
+}
+
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::CircularBuffer(const CircularBuffer<T, Allocator> &other)
+    : capacity_(other.capacity_),
+      head_(0),
+      tail_(other.Size()),
+      size_(other.size_),
+      allocator_(AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
+    buffer_ = Allocate(capacity_);
     Copy(buffer_, other.buffer_, capacity_, other.head_, other.tail_);
 }
 
-template <class T>
-CircularBuffer<T> &CircularBuffer<T>::operator=(const CircularBuffer<T> &other) {
+template <class T, class Allocator>
+CircularBuffer<T, Allocator> &CircularBuffer<T, Allocator>::operator=(const CircularBuffer<T, Allocator> &other) {
     if (&other != this) {
+        if (AllocatorTraits::propagate_on_container_copy_assignment::value && allocator_ != other.allocator_) {
+            Deallocate(buffer_, capacity_);
+            buffer_ = nullptr;
+            capacity_ = 0;
+            allocator_ = other.allocator_;
+        }
         BufferReallocation(other.capacity_, false);
         Copy(buffer_, other.buffer_, capacity_, other.head_, other.tail_);
         head_ = 0;
@@ -90,58 +151,58 @@ CircularBuffer<T> &CircularBuffer<T>::operator=(const CircularBuffer<T> &other)
     return *this;
 }
 
-template <class T>
-CircularBuffer<T>::~CircularBuffer() {
-    delete[] buffer_;
+template <class T, class Allocator>
+CircularBuffer<T, Allocator>::~CircularBuffer() {
+    Deallocate(buffer_, capacity_);
 }
 
-template <class T>
-const T &CircularBuffer<T>::operator[](size_t idx) const {
+template <class T, class Allocator>
+const T &CircularBuffer<T, Allocator>::operator[](size_t idx) const {
     return buffer_[(head_ + idx) % capacity_];
 }
 
-template <class T>
-T &CircularBuffer<T>::operator[](size_t idx) {
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::operator[](size_t idx) {
     return buffer_[(head_ + idx) % capacity_];
 }
 
-template <class T>
-T CircularBuffer<T>::Front() const {
+template <class T, class Allocator>
+T CircularBuffer<T, Allocator>::Front() const {
     return buffer_[head_];
 }
 
-template <class T>
-T &CircularBuffer<T>::Front() {
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::Front() {
     return buffer_[head_];
 }
 
-template <class T>
-T CircularBuffer<T>::Back() const {
+template <class T, class Allocator>
+T CircularBuffer<T, Allocator>::Back() const {
     return buffer_[tail_ - 1];
 }
 
-template <class T>
-T &CircularBuffer<T>::Back() {
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::Back() {
     return buffer_[tail_ - 1];
 }
 
-template <class T>
-bool CircularBuffer<T>::Empty() const {
+template <class T, class Allocator>
+bool CircularBuffer<T, Allocator>::Empty() const {
     return (size_ == 0);
 }
 
-template <class T>
-size_t CircularBuffer<T>::Size() const {
+template <class T, class Allocator>
+size_t CircularBuffer<T, Allocator>::Size() const {
     return size_;
 }
 
-template <class T>
-size_t CircularBuffer<T>::Capacity() const {
+template <class T, class Allocator>
+size_t CircularBuffer<T, Allocator>::Capacity() const {
     return capacity_;
 }
 
-template <class T>
-void CircularBuffer<T>::PushBack(const T &value) {
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::PushBack(const T &value) {
     if (size_ == capacity_) {
         BufferReallocation(IncreaseCapacity(), true);
     }
@@ -153,8 +214,8 @@ void CircularBuffer<T>::PushBack(const T &value) {
     ++size_;
 }
 
-template <class T>
-void CircularBuffer<T>::PushFront(const T &value) {
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::PushFront(const T &value) {
     if (size_ == capacity_) {
         BufferReallocation(IncreaseCapacity(), true);
     }
@@ -166,8 +227,8 @@ void CircularBuffer<T>::PushFront(const T &value) {
     ++size_;
 }
 
-template <class T>
-T &CircularBuffer<T>::PopBack() {
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::PopBack() {
     T &result = buffer_[tail_ - 1];
     if (tail_ == 1) {
         tail_ = capacity_ + 1;
@@ -177,8 +238,8 @@ T &CircularBuffer<T>::PopBack() {
     return result;
 }
 
-template <class T>
-T &CircularBuffer<T>::PopFront() {
+template <class T, class Allocator>
+T &CircularBuffer<T, Allocator>::PopFront() {
     T &result = buffer_[head_];
     if (head_ == capacity_ - 1) {
         head_ = 0;
@@ -189,34 +250,43 @@ T &CircularBuffer<T>::PopFront() {
     return result;
 }
 
-template <class T>
-void CircularBuffer<T>::Clear() {
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::Clear() {
     size_ = head_ = 0;
     tail_ = 1;
 }
 
-template <class T>
-void CircularBuffer<T>::Reserve(const size_t new_capacity) {
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::Reserve(const size_t new_capacity) {
     BufferReallocation(std::max(capacity_, new_capacity), true);
 }
 
-template <class T>
-void CircularBuffer<T>::Swap(CircularBuffer<T> &other) {
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::Swap(CircularBuffer<T, Allocator> &other) {
     std::swap(buffer_, other.buffer_);
     ::Swap(capacity_, other.capacity_);
     ::Swap(head_, other.head_);
     ::Swap(tail_, other.tail_);
     ::Swap(size_, other.size_);
+    if (AllocatorTraits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
 }
 
-template <class T>
-size_t CircularBuffer<T>::IncreaseCapacity() const {
+template <class T, class Allocator>
+Allocator CircularBuffer<T, Allocator>::GetAllocator() const {
+    return allocator_;
+}
+
+template <class T, class Allocator>
+size_t CircularBuffer<T, Allocator>::IncreaseCapacity() const {
     return (capacity_ == 0) ? 1 : capacity_ * kIncreaseFactor;
 }
 
-template <class T>
-void CircularBuffer<T>::BufferReallocation(const size_t new_capacity, bool needs_copy) {
-    T *new_buffer = (new_capacity == 0) ? nullptr : new T[new_capacity];
+template <class T, class Allocator>
+void CircularBuffer<T, Allocator>::BufferReallocation(const size_t new_capacity, bool needs_copy) {
+    T *new_buffer = Allocate(new_capacity);
     if (new_capacity >= capacity_) {
         if (needs_copy) {
             Copy(new_buffer, buffer_, capacity_, head_, tail_);
@@ -224,7 +294,7 @@ void CircularBuffer<T>::BufferReallocation(const size_t new_capacity, bool needs
             head_ = 0;
         }
     }
-    delete[] buffer_;
+    Deallocate(buffer_, capacity_);
     capacity_ = new_capacity;
     buffer_ = new_buffer;
 }
@@ -0,0 +1,367 @@
+#ifndef VECTOR_ALLOCATORS_H
+#define VECTOR_ALLOCATORS_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Memory resources for containers whose elements die together, such as the vectors of one request,
+// and the std::allocator_traits compatible allocators that draw from them. The resources are not
+// thread safe and must outlive every container that uses them.
+
+// Hands out memory from a chain of blocks by bumping a pointer and frees it all at once in Release or
+// the destructor. Freeing the latest allocation gives its memory back, and Reallocate resizes it in
+// place while its block has room, so a vector of IsTriviallyRelocatable elements that grows on top of
+// the arena keeps a single buffer. Other vectors build the new buffer before they free the old one,
+// which then stays used until Release.
+class MonotonicArena {
+private:
+    struct Block {
+        Block *next;
+    };
+    // Keeps the memory after a Block header aligned like the memory of ::operator new.
+    const static size_t kHeaderSize = (sizeof(Block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+                                      alignof(std::max_align_t);
+    Block *blocks_;
+    char *position_;
+    char *end_;
+    size_t block_size_;
+
+public:
+    explicit MonotonicArena(const size_t block_size = 64 * 1024)
+        : blocks_(nullptr), position_(nullptr), end_(nullptr), block_size_(block_size) {
+    }
+    MonotonicArena(const MonotonicArena &other) = delete;
+    MonotonicArena &operator=(const MonotonicArena &other) = delete;
+    ~MonotonicArena() {
+        Release();
+    }
+
+    void *Allocate(const size_t bytes, const size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(position_) % alignment) % alignment;
+        if (position_ == nullptr || static_cast<size_t>(end_ - position_) < padding + bytes) {
+            AddBlock(bytes + alignment);
+            padding = (alignment - reinterpret_cast<uintptr_t>(position_) % alignment) % alignment;
+        }
+        char *result = position_ + padding;
+        position_ = result + bytes;
+        return result;
+    }
+
+    void Deallocate(void *pointer, const size_t bytes) {
+        if (static_cast<char *>(pointer) + bytes == position_) {
+            position_ = static_cast<char *>(pointer);
+        }
+    }
+
+    // Resizes an allocation of old_bytes to new_bytes and returns where it is, keeping the contents that
+    // fit. Only the latest allocation can be resized in place; the others are copied.
+    void *Reallocate(void *pointer, const size_t old_bytes, const size_t new_bytes, const size_t alignment) {
+        char *start = static_cast<char *>(pointer);
+        if (start + old_bytes == position_ && static_cast<size_t>(end_ - start) >= new_bytes) {
+            position_ = start + new_bytes;
+            return pointer;
+        }
+        void *result = Allocate(new_bytes, alignment);
+        memcpy(result, pointer, (old_bytes < new_bytes) ? old_bytes : new_bytes);
+        return result;
+    }
+
+    // Frees every block, the memory handed out so far included.
+    void Release() {
+        while (blocks_ != nullptr) {
+            Block *next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+        position_ = end_ = nullptr;
+    }
+
+private:
+    // Blocks grow geometrically so that the number of blocks stays logarithmic in the memory used.
+    void AddBlock(const size_t min_bytes) {
+        size_t bytes = (min_bytes > block_size_) ? min_bytes : block_size_;
+        Block *block = static_cast<Block *>(::operator new(kHeaderSize + bytes));
+        block->next = blocks_;
+        blocks_ = block;
+        position_ = reinterpret_cast<char *>(block) + kHeaderSize;
+        end_ = position_ + bytes;
+        block_size_ *= 2;
+    }
+};
+
+// Keeps freed memory in lists per power of two size class and hands it out again, so that the
+// buffers of short-lived containers come back without going through ::operator new. Requests above
+// kMaxPooledBytes go straight to ::operator new.
+class PoolResource {
+private:
+    struct Node {
+        Node *next;
+    };
+    const static size_t kMinClassBits = 4;
+    const static size_t kClasses = 13;
+    const static size_t kSlabBytes = 64 * 1024;
+    Node *free_[kClasses];
+    // Slabs the size classes are carved from, chained through their first bytes.
+    Node *slabs_;
+
+    static size_t SizeClass(const size_t bytes) {
+        size_t size_class = 0;
+        while ((static_cast<size_t>(1) << (size_class + kMinClassBits)) < bytes) {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    void Refill(const size_t size_class) {
+        size_t block = static_cast<size_t>(1) << (size_class + kMinClassBits);
+        size_t header = alignof(std::max_align_t);
+        size_t count = (kSlabBytes - header) / block;
+        count = (count == 0) ? 1 : count;
+        char *slab = static_cast<char *>(::operator new(header + count * block));
+        Node *slab_node = reinterpret_cast<Node *>(slab);
+        slab_node->next = slabs_;
+        slabs_ = slab_node;
+        for (size_t i = count; i > 0; --i) {
+            Node *node = reinterpret_cast<Node *>(slab + header + (i - 1) * block);
+            node->next = free_[size_class];
+            free_[size_class] = node;
+        }
+    }
+
+public:
+    const static size_t kMaxPooledBytes = static_cast<size_t>(1) << (kMinClassBits + kClasses - 1);
+
+    PoolResource() : slabs_(nullptr) {
+        for (size_t i = 0; i < kClasses; ++i) {
+            free_[i] = nullptr;
+        }
+    }
+    PoolResource(const PoolResource &other) = delete;
+    PoolResource &operator=(const PoolResource &other) = delete;
+    ~PoolResource() {
+        while (slabs_ != nullptr) {
+            Node *next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+    }
+
+    // Pooled memory is aligned like the memory of ::operator new.
+    void *Allocate(const size_t bytes) {
+        if (bytes > kMaxPooledBytes) {
+            return ::operator new(bytes);
+        }
+        size_t size_class = SizeClass(bytes);
+        if (free_[size_class] == nullptr) {
+            Refill(size_class);
+        }
+        Node *node = free_[size_class];
+        free_[size_class] = node->next;
+        return node;
+    }
+
+    void Deallocate(void *pointer, const size_t bytes) {
+        if (bytes > kMaxPooledBytes) {
+            ::operator delete(pointer);
+            return;
+        }
+        size_t size_class = SizeClass(bytes);
+        Node *node = static_cast<Node *>(pointer);
+        node->next = free_[size_class];
+        free_[size_class] = node;
+    }
+};
+
+// Allocators over the resources above. Containers take the resource along when they are moved or
+// swapped, and copies stay with the resource of the container they are assigned to.
+template <class T>
+class ArenaAllocator {
+private:
+    MonotonicArena *arena_;
+
+    template <class U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(MonotonicArena *arena) : arena_(arena) {
+    }
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena_) {  //  NOLINT
+    }
+
+    T *allocate(const size_t count) {
+        return static_cast<T *>(arena_->Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *pointer, const size_t count) {
+        arena_->Deallocate(pointer, count * sizeof(T));
+    }
+
+    // Lets Vector grow a buffer of trivially relocatable elements in place, see MonotonicArena.
+    T *reallocate(T *pointer, const size_t old_count, const size_t new_count) {
+        return static_cast<T *>(arena_->Reallocate(pointer, old_count * sizeof(T), new_count * sizeof(T), alignof(T)));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return arena_ != other.arena_;
+    }
+};
+
+template <class T>
+class PoolAllocator {
+private:
+    PoolResource *pool_;
+
+    template <class U>
+    friend class PoolAllocator;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit PoolAllocator(PoolResource *pool) : pool_(pool) {
+    }
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &other) : pool_(other.pool_) {  //  NOLINT
+    }
+
+    T *allocate(const size_t count) {
+        return static_cast<T *>(pool_->Allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, const size_t count) {
+        pool_->Deallocate(pointer, count * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U> &other) const {
+        return pool_ == other.pool_;
+    }
+
+    template <class U>
+    bool operator!=(const PoolAllocator<U> &other) const {
+        return pool_ != other.pool_;
+    }
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+// Gives buffers of at least kMapBytes their own anonymous mappings, which reallocate resizes with
+// mremap on Linux: the pages move to wherever the mapping fits without their contents being
+// copied. Vector uses reallocate for IsTriviallyRelocatable elements, so a vector of gigabytes grows
+// without a copy per growth step and without leaving holes in the heap. Smaller buffers come from
+// ::operator new. With huge_pages the mappings are advised to be backed by transparent huge pages.
+template <class T>
+class PageAllocator {
+private:
+    bool huge_pages_;
+
+    template <class U>
+    friend class PageAllocator;
+
+    static size_t MappedBytes(const size_t bytes) {
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) / page * page;
+    }
+
+    void Advise(void *pointer, const size_t bytes) const {
+#if defined(MADV_HUGEPAGE)
+        if (huge_pages_) {
+            madvise(pointer, MappedBytes(bytes), MADV_HUGEPAGE);
+        }
+#else
+        (void)pointer;
+        (void)bytes;
+#endif
+    }
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+    const static size_t kMapBytes = static_cast<size_t>(2) << 20;
+
+    explicit PageAllocator(const bool huge_pages = false) : huge_pages_(huge_pages) {
+    }
+    template <class U>
+    PageAllocator(const PageAllocator<U> &other) : huge_pages_(other.huge_pages_) {  //  NOLINT
+    }
+
+    T *allocate(const size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < kMapBytes) {
+            return static_cast<T *>(::operator new(bytes));
+        }
+        void *pointer = mmap(nullptr, MappedBytes(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pointer == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        Advise(pointer, bytes);
+        return static_cast<T *>(pointer);
+    }
+
+    void deallocate(T *pointer, const size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (bytes < kMapBytes) {
+            ::operator delete(pointer);
+        } else {
+            munmap(pointer, MappedBytes(bytes));
+        }
+    }
+
+    // Resizes a buffer of old_count trivially relocatable elements to new_count, keeping the contents
+    // that fit.
+    T *reallocate(T *pointer, const size_t old_count, const size_t new_count) {
+        size_t old_bytes = old_count * sizeof(T);
+        size_t new_bytes = new_count * sizeof(T);
+#if defined(__linux__)
+        if (old_bytes >= kMapBytes && new_bytes >= kMapBytes) {
+            void *moved = mremap(pointer, MappedBytes(old_bytes), MappedBytes(new_bytes), MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED) {
+                throw std::bad_alloc{};
+            }
+            if (new_bytes > old_bytes) {
+                Advise(moved, new_bytes);
+            }
+            return static_cast<T *>(moved);
+        }
+#endif
+        T *result = allocate(new_count);
+        memcpy(static_cast<void *>(result), static_cast<const void *>(pointer),
+               (old_bytes < new_bytes) ? old_bytes : new_bytes);
+        deallocate(pointer, old_count);
+        return result;
+    }
+
+    template <class U>
+    bool operator==(const PageAllocator<U> &) const {
+        return true;
+    }
+
+    template <class U>
+    bool operator!=(const PageAllocator<U> &) const {
+        return false;
+    }
+};
+#endif
+
+#endif  // VECTOR_ALLOCATORS_H
@@ -0,0 +1,680 @@
+#ifndef VECTOR_MAPPED_VECTOR_H
+#define VECTOR_MAPPED_VECTOR_H
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "vector.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Thrown with errno when the system fails to open, resize, map or sync the file of a MappedVector.
+class MappedVectorError : public std::system_error {
+public:
+    MappedVectorError() : std::system_error(errno, std::generic_category(), "MappedVectorError") {
+    }
+};
+
+// Thrown when an existing file was not written by a MappedVector of the same element size.
+class MappedVectorInvalidFile : public std::runtime_error {
+public:
+    MappedVectorInvalidFile() : std::runtime_error("MappedVectorInvalidFile") {
+    }
+};
+
+// kOpenOrCreate keeps the elements of an existing file, kCreate starts from an empty one and kOpen
+// throws MappedVectorError if there is no file yet.
+enum class MappedVectorMode { kOpenOrCreate, kCreate, kOpen };
+
+// Access pattern hints for the kernel's read-ahead, see Advise.
+enum class MappedVectorAccess { kNormal, kSequential, kRandom };
+
+namespace vector_detail {
+
+struct MappedVectorHeader {
+    char magic[8];
+    uint64_t element_size;
+    uint64_t size;
+};
+
+constexpr char kMappedVectorMagic[8] = {'M', 'A', 'P', 'V', 'E', 'C', '0', '1'};
+// The elements start here, aligned for any T with alignof(T) up to this much.
+constexpr size_t kMappedVectorHeaderBytes = 64;
+
+}  // namespace vector_detail
+
+// Vector of trivially copyable elements that live in a file mapped into memory. A MappedVector
+// opened over an existing file starts without reading or parsing anything: the pages of the file
+// come in as the elements are touched, and the ones that are not needed stay on disk, so the data
+// may be larger than RAM. The file holds a header with the number of elements, which is written on
+// Flush and on destruction, and the elements after it in the layout of the machine that wrote them.
+// Growing extends the file with ftruncate and the mapping with mremap on Linux, or with a new
+// mapping elsewhere. Like with Vector, growth invalidates pointers and references to the elements.
+template <class T, class GrowthPolicy = DoublingGrowth>
+class MappedVector {
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "MappedVector stores trivially copyable types only");
+    static_assert(alignof(T) <= vector_detail::kMappedVectorHeaderBytes,
+                  "MappedVector does not support over-aligned types");
+
+    int file_;
+    char *mapping_;
+    size_t mapped_bytes_;
+    T *buffer_;
+    size_t size_;
+    size_t capacity_;
+    MappedVectorAccess access_;
+
+    static size_t FileBytes(const size_t capacity);
+    vector_detail::MappedVectorHeader *Header();
+    void Map(const size_t bytes);
+    void Remap(const size_t capacity);
+    void Close();
+    size_t GrownCapacity(const size_t required) const;
+    // Makes room for count elements at position by shifting the ones after it, without changing size_.
+    void OpenGap(const size_t position, const size_t count);
+    template <class InputIt>
+    void InsertRange(const size_t position, InputIt first, InputIt last, std::input_iterator_tag);
+    template <class ForwardIt>
+    void InsertRange(const size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+public:
+    explicit MappedVector(const std::string &path, const MappedVectorMode mode = MappedVectorMode::kOpenOrCreate);
+    MappedVector(const MappedVector<T, GrowthPolicy> &other) = delete;
+    MappedVector<T, GrowthPolicy> &operator=(const MappedVector<T, GrowthPolicy> &other) = delete;
+    MappedVector(MappedVector<T, GrowthPolicy> &&other) noexcept;
+    MappedVector<T, GrowthPolicy> &operator=(MappedVector<T, GrowthPolicy> &&other) noexcept;
+    ~MappedVector();
+    void Clear();
+    void PushBack(const T &value);
+    // Constructs the new last element from args, which may refer to an element of the vector.
+    template <class... Args>
+    T &EmplaceBack(Args &&... args);
+    // Removes the last element and returns its value.
+    T PopBack();
+    // The range operations grow the file at most once for forward iterators. Forward ranges may refer to
+    // elements of the vector itself, single pass ranges must not.
+    template <class InputIt, class = typename std::enable_if<vector_detail::IsInputIterator<InputIt>::value>::type>
+    void Append(InputIt first, InputIt last);
+    void Append(std::initializer_list<T> values);
+    // Inserting at a position beyond Size() or erasing outside of the elements throws VectorOutOfRange.
+    template <class... Args>
+    T &Emplace(const size_t position, Args &&... args);
+    void Insert(const size_t position, const T &value);
+    template <class InputIt, class = typename std::enable_if<vector_detail::IsInputIterator<InputIt>::value>::type>
+    void Insert(const size_t position, InputIt first, InputIt last);
+    void Insert(const size_t position, std::initializer_list<T> values);
+    void Erase(const size_t position);
+    void Erase(const size_t first, const size_t last);
+    // Moves the last element into position instead of shifting the ones after it, so the order is lost.
+    void SwapErase(const size_t position);
+    void Resize(const size_t new_size);
+    void Resize(const size_t new_size, const T &value);
+    // The file always ends at a page boundary, so the capacity is rounded up to the elements that fit.
+    void Reserve(const size_t new_capacity);
+    void ShrinkToFit();
+    void Swap(MappedVector<T, GrowthPolicy> &other);
+    const T &operator[](size_t idx) const;
+    T &operator[](size_t idx);
+    const T At(size_t idx) const;
+    T &At(size_t idx);
+    T Front() const;
+    T &Front();
+    T Back() const;
+    T &Back();
+    bool Empty() const;
+    size_t Size() const;
+    size_t Capacity() const;
+    const T *Data() const;
+    T *Data();
+    bool operator<(const MappedVector<T, GrowthPolicy> &other) const;
+    bool operator>(const MappedVector<T, GrowthPolicy> &other) const;
+    bool operator==(const MappedVector<T, GrowthPolicy> &other) const;
+    bool operator<=(const MappedVector<T, GrowthPolicy> &other) const;
+    bool operator>=(const MappedVector<T, GrowthPolicy> &other) const;
+    bool operator!=(const MappedVector<T, GrowthPolicy> &other) const;
+    // Assigns value to the elements from start to end.
+    void Fill(const size_t start, const size_t end, const T &value);
+    // Index of the first element equal to value, Size() if there is none.
+    size_t Find(const T &value) const;
+    size_t Count(const T &value) const;
+    // Smallest and largest element; throws VectorOutOfRange if the vector is empty.
+    std::pair<T, T> MinMax() const;
+    // Capacity the growth policy gives for one more element.
+    size_t IncreaseCapacity() const;
+    // Writes the size and every modified page to the file and waits until they are on disk.
+    void Flush();
+    // Tells the kernel how the elements are going to be read: kSequential reads ahead aggressively and
+    // drops pages behind, kRandom reads only the pages touched. The hint survives growth.
+    void Advise(const MappedVectorAccess access);
+};
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::FileBytes(const size_t capacity) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t bytes = vector_detail::kMappedVectorHeaderBytes + capacity * sizeof(T);
+    return (bytes + page - 1) / page * page;
+}
+
+template <class T, class GrowthPolicy>
+vector_detail::MappedVectorHeader *MappedVector<T, GrowthPolicy>::Header() {
+    return reinterpret_cast<vector_detail::MappedVectorHeader *>(mapping_);
+}
+
+// Maps the first bytes of the file, which is at least that long.
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Map(const size_t bytes) {
+    void *mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+    if (mapping == MAP_FAILED) {
+        throw MappedVectorError{};
+    }
+    mapping_ = static_cast<char *>(mapping);
+    mapped_bytes_ = bytes;
+    buffer_ = reinterpret_cast<T *>(mapping_ + vector_detail::kMappedVectorHeaderBytes);
+}
+
+// Resizes the file and the mapping to hold capacity >= size_ elements. The file grows before the
+// mapping and shrinks after it, so that no mapped page is ever beyond the end of the file.
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Remap(const size_t capacity) {
+    size_t bytes = FileBytes(capacity);
+    if (bytes == mapped_bytes_) {
+        return;
+    }
+    if (bytes > mapped_bytes_ && ftruncate(file_, static_cast<off_t>(bytes)) != 0) {
+        throw MappedVectorError{};
+    }
+#if defined(__linux__)
+    void *mapping = mremap(mapping_, mapped_bytes_, bytes, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) {
+        throw MappedVectorError{};
+    }
+#else
+    void *mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+    if (mapping == MAP_FAILED) {
+        throw MappedVectorError{};
+    }
+    munmap(mapping_, mapped_bytes_);
+#endif
+    bool shrinks = bytes < mapped_bytes_;
+    mapping_ = static_cast<char *>(mapping);
+    mapped_bytes_ = bytes;
+    buffer_ = reinterpret_cast<T *>(mapping_ + vector_detail::kMappedVectorHeaderBytes);
+    capacity_ = (bytes - vector_detail::kMappedVectorHeaderBytes) / sizeof(T);
+    if (shrinks && ftruncate(file_, static_cast<off_t>(bytes)) != 0) {
+        throw MappedVectorError{};
+    }
+    if (access_ != MappedVectorAccess::kNormal) {
+        Advise(access_);
+    }
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Close() {
+    if (mapping_ != nullptr) {
+        Header()->size = size_;
+        munmap(mapping_, mapped_bytes_);
+    }
+    if (file_ >= 0) {
+        close(file_);
+    }
+    file_ = -1;
+    mapping_ = nullptr;
+    buffer_ = nullptr;
+    mapped_bytes_ = size_ = capacity_ = 0;
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(const std::string &path, const MappedVectorMode mode)
+    : file_(-1),
+      mapping_(nullptr),
+      mapped_bytes_(0),
+      buffer_(nullptr),
+      size_(0),
+      capacity_(0),
+      access_(MappedVectorAccess::kNormal) {
+    int flags = O_RDWR | O_CLOEXEC;
+    if (mode != MappedVectorMode::kOpen) {
+        flags |= O_CREAT;
+    }
+    if (mode == MappedVectorMode::kCreate) {
+        flags |= O_TRUNC;
+    }
+    file_ = open(path.c_str(), flags, 0644);
+    if (file_ < 0) {
+        throw MappedVectorError{};
+    }
+    try {
+        struct stat status;
+        if (fstat(file_, &status) != 0) {
+            throw MappedVectorError{};
+        }
+        size_t bytes = static_cast<size_t>(status.st_size);
+        if (bytes == 0) {
+            bytes = FileBytes(0);
+            if (ftruncate(file_, static_cast<off_t>(bytes)) != 0) {
+                throw MappedVectorError{};
+            }
+            Map(bytes);
+            memcpy(Header()->magic, vector_detail::kMappedVectorMagic, sizeof(vector_detail::kMappedVectorMagic));
+            Header()->element_size = sizeof(T);
+            Header()->size = 0;
+        } else {
+            if (bytes < vector_detail::kMappedVectorHeaderBytes) {
+                throw MappedVectorInvalidFile{};
+            }
+            Map(bytes);
+            const vector_detail::MappedVectorHeader *header = Header();
+            if (memcmp(header->magic, vector_detail::kMappedVectorMagic, sizeof(header->magic)) != 0 ||
+                header->element_size != sizeof(T) ||
+                header->size > (bytes - vector_detail::kMappedVectorHeaderBytes) / sizeof(T)) {
+                throw MappedVectorInvalidFile{};
+            }
+            size_ = static_cast<size_t>(header->size);
+        }
+        capacity_ = (bytes - vector_detail::kMappedVectorHeaderBytes) / sizeof(T);
+    } catch (...) {
+        // Leaves the header of a file that is not ours alone.
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapped_bytes_);
+            mapping_ = nullptr;
+        }
+        Close();
+        throw;
+    }
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector<T, GrowthPolicy> &&other) noexcept
+    : file_(other.file_),
+      mapping_(other.mapping_),
+      mapped_bytes_(other.mapped_bytes_),
+      buffer_(other.buffer_),
+      size_(other.size_),
+      capacity_(other.capacity_),
+      access_(other.access_) {
+    other.file_ = -1;
+    other.mapping_ = nullptr;
+    other.buffer_ = nullptr;
+    other.mapped_bytes_ = other.size_ = other.capacity_ = 0;
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy> &MappedVector<T, GrowthPolicy>::operator=(
+    MappedVector<T, GrowthPolicy> &&other) noexcept {
+    if (&other != this) {
+        Close();
+        Swap(other);
+    }
+    return *this;
+}
+
+template <class T, class GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector() {
+    Close();
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Clear() {
+    size_ = 0;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PushBack(const T &value) {
+    EmplaceBack(value);
+}
+
+// The mapping may move, so the new element is built aside in case args refer to an element.
+template <class T, class GrowthPolicy>
+template <class... Args>
+T &MappedVector<T, GrowthPolicy>::EmplaceBack(Args &&... args) {
+    T value(std::forward<Args>(args)...);
+    if (size_ == capacity_) {
+        Remap(IncreaseCapacity());
+    }
+    ::new (static_cast<void *>(buffer_ + size_)) T(value);
+    ++size_;
+    return buffer_[size_ - 1];
+}
+
+template <class T, class GrowthPolicy>
+T MappedVector<T, GrowthPolicy>::PopBack() {
+    --size_;
+    return buffer_[size_];
+}
+
+template <class T, class GrowthPolicy>
+template <class InputIt, class>
+void MappedVector<T, GrowthPolicy>::Append(InputIt first, InputIt last) {
+    InsertRange(size_, first, last, typename vector_detail::IteratorCategory<InputIt>::type());
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Append(std::initializer_list<T> values) {
+    Append(values.begin(), values.end());
+}
+
+template <class T, class GrowthPolicy>
+template <class... Args>
+T &MappedVector<T, GrowthPolicy>::Emplace(const size_t position, Args &&... args) {
+    if (position > size_) {
+        throw VectorOutOfRange{};
+    }
+    T value(std::forward<Args>(args)...);
+    OpenGap(position, 1);
+    ::new (static_cast<void *>(buffer_ + position)) T(value);
+    ++size_;
+    return buffer_[position];
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Insert(const size_t position, const T &value) {
+    Emplace(position, value);
+}
+
+template <class T, class GrowthPolicy>
+template <class InputIt, class>
+void MappedVector<T, GrowthPolicy>::Insert(const size_t position, InputIt first, InputIt last) {
+    if (position > size_) {
+        throw VectorOutOfRange{};
+    }
+    InsertRange(position, first, last, typename vector_detail::IteratorCategory<InputIt>::type());
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Insert(const size_t position, std::initializer_list<T> values) {
+    Insert(position, values.begin(), values.end());
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::OpenGap(const size_t position, const size_t count) {
+    if (size_ + count > capacity_) {
+        Remap(GrownCapacity(size_ + count));
+    }
+    vector_detail::RelocateOverlapping(buffer_ + position + count, buffer_ + position, size_ - position);
+}
+
+template <class T, class GrowthPolicy>
+template <class InputIt>
+void MappedVector<T, GrowthPolicy>::InsertRange(const size_t position, InputIt first, InputIt last,
+                                                std::input_iterator_tag) {
+    size_t old_size = size_;
+    for (; first != last; ++first) {
+        EmplaceBack(*first);
+    }
+    std::rotate(buffer_ + position, buffer_ + old_size, buffer_ + size_);
+}
+
+template <class T, class GrowthPolicy>
+template <class ForwardIt>
+void MappedVector<T, GrowthPolicy>::InsertRange(const size_t position, ForwardIt first, ForwardIt last,
+                                                std::forward_iterator_tag) {
+    if (!std::is_pointer<ForwardIt>::value || vector_detail::PointsInto(first, buffer_, size_)) {
+        // A range into the elements would move along with the mapping and the shifted elements, and only
+        // for pointers can that be ruled out, so other ranges are copied out first.
+        Vector<T> copy(first, last);
+        InsertRange(position, copy.Data(), copy.Data() + copy.Size(), std::random_access_iterator_tag());
+        return;
+    }
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count == 0) {
+        return;
+    }
+    OpenGap(position, count);
+    T *gap = buffer_ + position;
+    try {
+        std::uninitialized_copy(first, last, gap);
+    } catch (...) {
+        vector_detail::RelocateOverlapping(gap, gap + count, size_ - position);
+        throw;
+    }
+    size_ += count;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Erase(const size_t position) {
+    Erase(position, position + 1);
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Erase(const size_t first, const size_t last) {
+    if (first > last || last > size_) {
+        throw VectorOutOfRange{};
+    }
+    vector_detail::RelocateOverlapping(buffer_ + first, buffer_ + last, size_ - last);
+    size_ -= last - first;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::SwapErase(const size_t position) {
+    if (position >= size_) {
+        throw VectorOutOfRange{};
+    }
+    --size_;
+    buffer_[position] = buffer_[size_];
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(const size_t new_size) {
+    if (new_size > capacity_) {
+        Remap(GrownCapacity(new_size));
+    }
+    if (new_size > size_) {
+        std::uninitialized_value_construct_n(buffer_ + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(const size_t new_size, const T &value) {
+    T copy(value);
+    if (new_size > capacity_) {
+        Remap(GrownCapacity(new_size));
+    }
+    if (new_size > size_) {
+        std::uninitialized_fill_n(buffer_ + size_, new_size - size_, copy);
+    }
+    size_ = new_size;
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Reserve(const size_t new_capacity) {
+    if (new_capacity > capacity_) {
+        Remap(new_capacity);
+    }
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::ShrinkToFit() {
+    Remap(size_);
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Swap(MappedVector<T, GrowthPolicy> &other) {
+    std::swap(file_, other.file_);
+    std::swap(mapping_, other.mapping_);
+    std::swap(mapped_bytes_, other.mapped_bytes_);
+    std::swap(buffer_, other.buffer_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(access_, other.access_);
+}
+
+template <class T, class GrowthPolicy>
+const T &MappedVector<T, GrowthPolicy>::operator[](size_t idx) const {
+    return buffer_[idx];
+}
+
+template <class T, class GrowthPolicy>
+T &MappedVector<T, GrowthPolicy>::operator[](size_t idx) {
+    return buffer_[idx];
+}
+
+template <class T, class GrowthPolicy>
+const T MappedVector<T, GrowthPolicy>::At(size_t idx) const {
+    if (idx >= size_) {
+        throw VectorOutOfRange{};
+    }
+    return buffer_[idx];
+}
+
+template <class T, class GrowthPolicy>
+T &MappedVector<T, GrowthPolicy>::At(size_t idx) {
+    if (idx >= size_) {
+        throw VectorOutOfRange{};
+    }
+    return buffer_[idx];
+}
+
+template <class T, class GrowthPolicy>
+T MappedVector<T, GrowthPolicy>::Front() const {
+    return buffer_[0];
+}
+
+template <class T, class GrowthPolicy>
+T &MappedVector<T, GrowthPolicy>::Front() {
+    return buffer_[0];
+}
+
+template <class T, class GrowthPolicy>
+T MappedVector<T, GrowthPolicy>::Back() const {
+    return buffer_[size_ - 1];
+}
+
+template <class T, class GrowthPolicy>
+T &MappedVector<T, GrowthPolicy>::Back() {
+    return buffer_[size_ - 1];
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::Empty() const {
+    return size_ == 0;
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Size() const {
+    return size_;
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Capacity() const {
+    return capacity_;
+}
+
+template <class T, class GrowthPolicy>
+const T *MappedVector<T, GrowthPolicy>::Data() const {
+    return buffer_;
+}
+
+template <class T, class GrowthPolicy>
+T *MappedVector<T, GrowthPolicy>::Data() {
+    return buffer_;
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator<(const MappedVector<T, GrowthPolicy> &other) const {
+    return vector_detail::Less(buffer_, size_, other.buffer_, other.size_);
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator>(const MappedVector<T, GrowthPolicy> &other) const {
+    return (other < *this);
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator==(const MappedVector<T, GrowthPolicy> &other) const {
+    return vector_detail::Equal(buffer_, size_, other.buffer_, other.size_);
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator<=(const MappedVector<T, GrowthPolicy> &other) const {
+    return !(other < *this);
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator>=(const MappedVector<T, GrowthPolicy> &other) const {
+    return !(*this < other);
+}
+
+template <class T, class GrowthPolicy>
+bool MappedVector<T, GrowthPolicy>::operator!=(const MappedVector<T, GrowthPolicy> &other) const {
+    return !(*this == other);
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Fill(const size_t start, const size_t end, const T &value) {
+    if (start < end) {
+        vector_detail::Fill(buffer_ + start, end - start, value);
+    }
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Find(const T &value) const {
+    return vector_detail::Find(buffer_, size_, value);
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Count(const T &value) const {
+    return vector_detail::Count(buffer_, size_, value);
+}
+
+template <class T, class GrowthPolicy>
+std::pair<T, T> MappedVector<T, GrowthPolicy>::MinMax() const {
+    if (size_ == 0) {
+        throw VectorOutOfRange{};
+    }
+    std::pair<T, T> result(buffer_[0], buffer_[0]);
+    vector_detail::MinMax(buffer_, size_, &result.first, &result.second);
+    return result;
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::IncreaseCapacity() const {
+    return GrownCapacity(capacity_ + 1);
+}
+
+template <class T, class GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::GrownCapacity(const size_t required) const {
+    return GrowthPolicy::NextCapacity(capacity_, required, sizeof(T));
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Flush() {
+    Header()->size = size_;
+    if (msync(mapping_, mapped_bytes_, MS_SYNC) != 0) {
+        throw MappedVectorError{};
+    }
+}
+
+template <class T, class GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Advise(const MappedVectorAccess access) {
+    int advice = MADV_NORMAL;
+    if (access == MappedVectorAccess::kSequential) {
+        advice = MADV_SEQUENTIAL;
+    } else if (access == MappedVectorAccess::kRandom) {
+        advice = MADV_RANDOM;
+    }
+    if (madvise(mapping_, mapped_bytes_, advice) != 0) {
+        throw MappedVectorError{};
+    }
+    access_ = access;
+}
+
+#endif
+
+#endif  // VECTOR_MAPPED_VECTOR_H
@@ -0,0 +1,295 @@
+#ifndef VECTOR_SIMD_H
+#define VECTOR_SIMD_H
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// AVX2 versions of the scans over arithmetic elements. They are compiled with a per-function target
+// attribute and picked at runtime, so the same binary still runs on processors without AVX2.
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#else
+#define VECTOR_HAS_AVX2_KERNELS 0
+#endif
+
+namespace vector_detail {
+
+// Shorter arrays are not worth the setup of the vector loop.
+constexpr size_t kSimdMinElements = 32;
+
+inline bool HasAvx2() {
+#if VECTOR_HAS_AVX2_KERNELS
+    static const bool kSupported = __builtin_cpu_supports("avx2") != 0;
+    return kSupported;
+#else
+    return false;
+#endif
+}
+
+// Integers are compared bit by bit, a lane of T takes sizeof(T) bits of a byte mask.
+template <class T>
+struct IsSimdInteger : std::integral_constant<bool, std::is_integral<T>::value> {};
+
+template <class T>
+struct IsSimdFloat
+    : std::integral_constant<bool, std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+// Element types with AVX2 minimum and maximum instructions.
+template <class T>
+struct HasSimdMinMax
+    : std::integral_constant<bool, IsSimdFloat<T>::value || (std::is_integral<T>::value && sizeof(T) <= 4 &&
+                                                             !std::is_same<T, bool>::value)> {};
+
+#if VECTOR_HAS_AVX2_KERNELS
+
+template <class T>
+__attribute__((target("avx2"))) inline __m256i Broadcast(const T value) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm256_set1_epi16(static_cast<int16_t>(value));
+    } else if constexpr (sizeof(T) == 4) {
+        return _mm256_set1_epi32(static_cast<int32_t>(value));
+    } else {
+        return _mm256_set1_epi64x(static_cast<int64_t>(value));
+    }
+}
+
+// Byte mask of the lanes of x equal to those of y.
+template <class T>
+__attribute__((target("avx2"))) inline uint32_t EqualBytes(const __m256i x, const __m256i y) {
+    __m256i equal;
+    if constexpr (sizeof(T) == 1) {
+        equal = _mm256_cmpeq_epi8(x, y);
+    } else if constexpr (sizeof(T) == 2) {
+        equal = _mm256_cmpeq_epi16(x, y);
+    } else if constexpr (sizeof(T) == 4) {
+        equal = _mm256_cmpeq_epi32(x, y);
+    } else {
+        equal = _mm256_cmpeq_epi64(x, y);
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+}
+
+__attribute__((target("avx2"))) inline __m256i Load(const void *pointer) {
+    return _mm256_loadu_si256(static_cast<const __m256i *>(pointer));
+}
+
+// Index of the first element equal to value, size if there is none.
+template <class T>
+__attribute__((target("avx2"))) inline size_t FindIntegerAvx2(const T *a, const size_t size, const T value) {
+    const size_t kLanes = 32 / sizeof(T);
+    const __m256i needle = Broadcast(value);
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        uint32_t mask = EqualBytes<T>(Load(a + i), needle);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+        }
+    }
+    for (; i < size; ++i) {
+        if (a[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline size_t CountIntegerAvx2(const T *a, const size_t size, const T value) {
+    const size_t kLanes = 32 / sizeof(T);
+    const __m256i needle = Broadcast(value);
+    size_t bytes = 0;
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        bytes += static_cast<size_t>(__builtin_popcount(EqualBytes<T>(Load(a + i), needle)));
+    }
+    size_t count = bytes / sizeof(T);
+    for (; i < size; ++i) {
+        count += (a[i] == value) ? 1 : 0;
+    }
+    return count;
+}
+
+// Index of the first element where a and b differ, size if there is none.
+template <class T>
+__attribute__((target("avx2"))) inline size_t MismatchIntegerAvx2(const T *a, const T *b, const size_t size) {
+    const size_t kLanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Load(a + i), Load(b + i))));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+        }
+    }
+    for (; i < size; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// Floating point lanes give one bit each. NPredicate is the _CMP_ predicate of the comparison.
+template <int NPredicate>
+__attribute__((target("avx2"))) inline uint32_t CompareLanes(const float *a, const __m256 y) {
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(a), y, NPredicate)));
+}
+
+template <int NPredicate>
+__attribute__((target("avx2"))) inline uint32_t CompareLanes(const double *a, const __m256d y) {
+    return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a), y, NPredicate)));
+}
+
+__attribute__((target("avx2"))) inline __m256 LoadFloats(const float *a) {
+    return _mm256_loadu_ps(a);
+}
+
+__attribute__((target("avx2"))) inline __m256d LoadFloats(const double *a) {
+    return _mm256_loadu_pd(a);
+}
+
+__attribute__((target("avx2"))) inline __m256 BroadcastFloat(const float value) {
+    return _mm256_set1_ps(value);
+}
+
+__attribute__((target("avx2"))) inline __m256d BroadcastFloat(const double value) {
+    return _mm256_set1_pd(value);
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline size_t FindFloatAvx2(const T *a, const size_t size, const T value) {
+    const size_t kLanes = 32 / sizeof(T);
+    const auto needle = BroadcastFloat(value);
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        uint32_t mask = CompareLanes<_CMP_EQ_OQ>(a + i, needle);
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    for (; i < size; ++i) {
+        if (a[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline size_t CountFloatAvx2(const T *a, const size_t size, const T value) {
+    const size_t kLanes = 32 / sizeof(T);
+    const auto needle = BroadcastFloat(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        count += static_cast<size_t>(__builtin_popcount(CompareLanes<_CMP_EQ_OQ>(a + i, needle)));
+    }
+    for (; i < size; ++i) {
+        count += (a[i] == value) ? 1 : 0;
+    }
+    return count;
+}
+
+// With NOrdered, the first element where a < b or a > b, which skips NaNs like a lexicographic
+// comparison through < does; otherwise the first one where a != b.
+template <bool NOrdered, class T>
+__attribute__((target("avx2"))) inline size_t MismatchFloatAvx2(const T *a, const T *b, const size_t size) {
+    const size_t kLanes = 32 / sizeof(T);
+    size_t i = 0;
+    for (; i + kLanes <= size; i += kLanes) {
+        uint32_t mask = NOrdered ? CompareLanes<_CMP_NEQ_OQ>(a + i, LoadFloats(b + i))
+                                 : CompareLanes<_CMP_NEQ_UQ>(a + i, LoadFloats(b + i));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    for (; i < size; ++i) {
+        if (NOrdered ? (a[i] < b[i] || a[i] > b[i]) : a[i] != b[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline __m256i MinLanes(const __m256i x, const __m256i y) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed<T>::value ? _mm256_min_epi8(x, y) : _mm256_min_epu8(x, y);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed<T>::value ? _mm256_min_epi16(x, y) : _mm256_min_epu16(x, y);
+    } else {
+        return std::is_signed<T>::value ? _mm256_min_epi32(x, y) : _mm256_min_epu32(x, y);
+    }
+}
+
+template <class T>
+__attribute__((target("avx2"))) inline __m256i MaxLanes(const __m256i x, const __m256i y) {
+    if constexpr (sizeof(T) == 1) {
+        return std::is_signed<T>::value ? _mm256_max_epi8(x, y) : _mm256_max_epu8(x, y);
+    } else if constexpr (sizeof(T) == 2) {
+        return std::is_signed<T>::value ? _mm256_max_epi16(x, y) : _mm256_max_epu16(x, y);
+    } else {
+        return std::is_signed<T>::value ? _mm256_max_epi32(x, y) : _mm256_max_epu32(x, y);
+    }
+}
+
+// Minimum and maximum of size >= 32 / sizeof(T) elements. Every lane keeps its own minimum and maximum,
+// so with NaNs among floating point elements the result depends on where they are.
+template <class T>
+__attribute__((target("avx2"))) inline void MinMaxAvx2(const T *a, const size_t size, T *min, T *max) {
+    const size_t kLanes = 32 / sizeof(T);
+    T lanes_min[kLanes];
+    T lanes_max[kLanes];
+    size_t i = kLanes;
+    if constexpr (IsSimdFloat<T>::value) {
+        auto low = LoadFloats(a);
+        auto high = low;
+        for (; i + kLanes <= size; i += kLanes) {
+            auto x = LoadFloats(a + i);
+            if constexpr (sizeof(T) == 4) {
+                low = _mm256_min_ps(x, low);
+                high = _mm256_max_ps(x, high);
+            } else {
+                low = _mm256_min_pd(x, low);
+                high = _mm256_max_pd(x, high);
+            }
+        }
+        if constexpr (sizeof(T) == 4) {
+            _mm256_storeu_ps(lanes_min, low);
+            _mm256_storeu_ps(lanes_max, high);
+        } else {
+            _mm256_storeu_pd(lanes_min, low);
+            _mm256_storeu_pd(lanes_max, high);
+        }
+    } else {
+        __m256i low = Load(a);
+        __m256i high = low;
+        for (; i + kLanes <= size; i += kLanes) {
+            __m256i x = Load(a + i);
+            low = MinLanes<T>(x, low);
+            high = MaxLanes<T>(x, high);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_min), low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes_max), high);
+    }
+    T result_min = lanes_min[0];
+    T result_max = lanes_max[0];
+    for (size_t lane = 1; lane < kLanes; ++lane) {
+        result_min = (lanes_min[lane] < result_min) ? lanes_min[lane] : result_min;
+        result_max = (result_max < lanes_max[lane]) ? lanes_max[lane] : result_max;
+    }
+    for (; i < size; ++i) {
+        result_min = (a[i] < result_min) ? a[i] : result_min;
+        result_max = (result_max < a[i]) ? a[i] : result_max;
+    }
+    *min = result_min;
+    *max = result_max;
+}
+
+#endif  // VECTOR_HAS_AVX2_KERNELS
+
+}  // namespace vector_detail
+
+#endif  // VECTOR_SIMD_H
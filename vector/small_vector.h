@@ -0,0 +1,486 @@
+#ifndef VECTOR_SMALL_VECTOR_H
+#define VECTOR_SMALL_VECTOR_H
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+// Vector with room for N elements inside the object: it only allocates once it grows beyond them,
+// and ShrinkToFit brings it back inside when the elements fit again. Moving an inline SmallVector
+// moves its elements one by one, or with memcpy for IsTriviallyRelocatable types.
+template <class T, size_t N, class Allocator = std::allocator<T>>
+class SmallVector {
+private:
+    static_assert(N > 0, "SmallVector needs room for at least one inline element");
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+    // Raw storage for capacity_ elements, either inline_ or a heap buffer of more than N, of which
+    // the first size_ are constructed.
+    T *buffer_;
+    size_t size_;
+    size_t capacity_;
+    Allocator allocator_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    const static size_t kIncreaseFactor = 2;
+
+    T *Inline();
+    void Deallocate(T *buffer, const size_t capacity);
+    template <class Construct>
+    void Grow(const size_t new_capacity, const size_t constructed, Construct construct);
+
+public:
+    SmallVector();
+    explicit SmallVector(const Allocator &allocator);
+    explicit SmallVector(const size_t size, const Allocator &allocator = Allocator());
+    SmallVector(const size_t size, const T &value, const Allocator &allocator = Allocator());
+    SmallVector(const SmallVector<T, N, Allocator> &other);
+    SmallVector(SmallVector<T, N, Allocator> &&other) noexcept(std::is_nothrow_move_constructible<T>::value);
+    // Copy assignment gives the basic guarantee only: it reuses the storage it has.
+    SmallVector<T, N, Allocator> &operator=(const SmallVector<T, N, Allocator> &other);
+    SmallVector<T, N, Allocator> &operator=(SmallVector<T, N, Allocator> &&other);
+    ~SmallVector();
+    void Clear();
+    void PushBack(const T &value);
+    void PushBack(T &&value);
+    // Constructs the new last element in place from args, which may refer to an element of the vector.
+    template <class... Args>
+    T &EmplaceBack(Args &&... args);
+    // Removes the last element and returns its value.
+    T PopBack();
+    void Resize(const size_t new_size);
+    void Resize(const size_t new_size, const T &value);
+    void Reserve(const size_t new_capacity);
+    void ShrinkToFit();
+    void Swap(SmallVector<T, N, Allocator> &other);
+    Allocator GetAllocator() const;
+    // Whether the elements are in the inline storage.
+    bool IsInline() const;
+    const T &operator[](size_t idx) const;
+    T &operator[](size_t idx);
+    const T At(size_t idx) const;
+    T &At(size_t idx);
+    T Front() const;
+    T &Front();
+    T Back() const;
+    T &Back();
+    bool Empty() const;
+    size_t Size() const;
+    size_t Capacity() const;
+    const T *Data() const;
+    T *Data();
+    bool operator<(const SmallVector<T, N, Allocator> &other) const;
+    bool operator>(const SmallVector<T, N, Allocator> &other) const;
+    bool operator==(const SmallVector<T, N, Allocator> &other) const;
+    bool operator<=(const SmallVector<T, N, Allocator> &other) const;
+    bool operator>=(const SmallVector<T, N, Allocator> &other) const;
+    bool operator!=(const SmallVector<T, N, Allocator> &other) const;
+    // Assigns value to the constructed elements from start to end.
+    void Fill(const size_t start, const size_t end, const T &value);
+    // Index of the first element equal to value, Size() if there is none.
+    size_t Find(const T &value) const;
+    size_t Count(const T &value) const;
+    // Smallest and largest element; throws VectorOutOfRange if the vector is empty.
+    std::pair<T, T> MinMax() const;
+    size_t IncreaseCapacity() const;
+    // Moves the elements to a buffer of new_capacity, the inline one if it fits, dropping those that
+    // do not fit.
+    void BufferReallocation(const size_t new_capacity);
+};
+
+template <class T, size_t N, class Allocator>
+T *SmallVector<T, N, Allocator>::Inline() {
+    return reinterpret_cast<T *>(inline_);
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Deallocate(T *buffer, const size_t capacity) {
+    if (buffer != Inline()) {
+        AllocatorTraits::deallocate(allocator_, buffer, capacity);
+    }
+}
+
+// Switches to a heap buffer of new_capacity > size_, like Vector::Grow.
+template <class T, size_t N, class Allocator>
+template <class Construct>
+void SmallVector<T, N, Allocator>::Grow(const size_t new_capacity, const size_t constructed, Construct construct) {
+    T *new_buffer = AllocatorTraits::allocate(allocator_, new_capacity);
+    try {
+        construct(new_buffer + size_);
+    } catch (...) {
+        AllocatorTraits::deallocate(allocator_, new_buffer, new_capacity);
+        throw;
+    }
+    try {
+        vector_detail::Relocate(new_buffer, buffer_, size_);
+    } catch (...) {
+        vector_detail::Destroy(new_buffer + size_, constructed);
+        AllocatorTraits::deallocate(allocator_, new_buffer, new_capacity);
+        throw;
+    }
+    Deallocate(buffer_, capacity_);
+    buffer_ = new_buffer;
+    capacity_ = new_capacity;
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector() : buffer_(Inline()), size_(0), capacity_(N) {
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const Allocator &allocator)
+    : buffer_(Inline()), size_(0), capacity_(N), allocator_(allocator) {
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const size_t size, const Allocator &allocator) : SmallVector(allocator) {
+    Resize(size);
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const size_t size, const T &value, const Allocator &allocator)
+    : SmallVector(allocator) {
+    Resize(size, value);
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const SmallVector<T, N, Allocator> &other)
+    : SmallVector(AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
+    Reserve(other.size_);
+    std::uninitialized_copy_n(other.buffer_, other.size_, buffer_);
+    size_ = other.size_;
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::SmallVector(SmallVector<T, N, Allocator> &&other) noexcept(
+    std::is_nothrow_move_constructible<T>::value)
+    : buffer_(Inline()), size_(0), capacity_(N), allocator_(std::move(other.allocator_)) {
+    if (other.IsInline()) {
+        vector_detail::Relocate(buffer_, other.buffer_, other.size_);
+    } else {
+        buffer_ = other.buffer_;
+        capacity_ = other.capacity_;
+        other.buffer_ = other.Inline();
+        other.capacity_ = N;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator> &SmallVector<T, N, Allocator>::operator=(const SmallVector<T, N, Allocator> &other) {
+    if (&other == this) {
+        return *this;
+    }
+    Clear();
+    if (AllocatorTraits::propagate_on_container_copy_assignment::value && allocator_ != other.allocator_) {
+        Deallocate(buffer_, capacity_);
+        buffer_ = Inline();
+        capacity_ = N;
+        allocator_ = other.allocator_;
+    }
+    Reserve(other.size_);
+    std::uninitialized_copy_n(other.buffer_, other.size_, buffer_);
+    size_ = other.size_;
+    return *this;
+}
+
+// Takes the heap buffer of other if it has one and the allocators allow it, otherwise moves the
+// elements one by one.
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator> &SmallVector<T, N, Allocator>::operator=(SmallVector<T, N, Allocator> &&other) {
+    if (&other == this) {
+        return *this;
+    }
+    Clear();
+    bool propagate = AllocatorTraits::propagate_on_container_move_assignment::value;
+    if (!other.IsInline() && (propagate || allocator_ == other.allocator_)) {
+        Deallocate(buffer_, capacity_);
+        if (propagate) {
+            allocator_ = std::move(other.allocator_);
+        }
+        buffer_ = other.buffer_;
+        capacity_ = other.capacity_;
+        other.buffer_ = other.Inline();
+        other.capacity_ = N;
+    } else {
+        Reserve(other.size_);
+        vector_detail::Relocate(buffer_, other.buffer_, other.size_);
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+    return *this;
+}
+
+template <class T, size_t N, class Allocator>
+SmallVector<T, N, Allocator>::~SmallVector() {
+    vector_detail::Destroy(buffer_, size_);
+    Deallocate(buffer_, capacity_);
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Clear() {
+    vector_detail::Destroy(buffer_, size_);
+    size_ = 0;
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::PushBack(const T &value) {
+    EmplaceBack(value);
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::PushBack(T &&value) {
+    EmplaceBack(std::move(value));
+}
+
+template <class T, size_t N, class Allocator>
+template <class... Args>
+T &SmallVector<T, N, Allocator>::EmplaceBack(Args &&... args) {
+    if (size_ < capacity_) {
+        ::new (static_cast<void *>(buffer_ + size_)) T(std::forward<Args>(args)...);
+    } else {
+        Grow(IncreaseCapacity(), 1,
+             [&](T *position) { ::new (static_cast<void *>(position)) T(std::forward<Args>(args)...); });
+    }
+    ++size_;
+    return buffer_[size_ - 1];
+}
+
+template <class T, size_t N, class Allocator>
+T SmallVector<T, N, Allocator>::PopBack() {
+    T result(std::move(buffer_[size_ - 1]));
+    --size_;
+    buffer_[size_].~T();
+    return result;
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Resize(const size_t new_size) {
+    if (new_size > capacity_) {
+        BufferReallocation(new_size);
+    }
+    if (new_size > size_) {
+        std::uninitialized_value_construct_n(buffer_ + size_, new_size - size_);
+    } else {
+        vector_detail::Destroy(buffer_ + new_size, size_ - new_size);
+    }
+    size_ = new_size;
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Resize(const size_t new_size, const T &value) {
+    if (new_size > capacity_) {
+        Grow(new_size, new_size - size_,
+             [&](T *position) { std::uninitialized_fill_n(position, new_size - size_, value); });
+    } else if (new_size > size_) {
+        std::uninitialized_fill_n(buffer_ + size_, new_size - size_, value);
+    } else {
+        vector_detail::Destroy(buffer_ + new_size, size_ - new_size);
+    }
+    size_ = new_size;
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Reserve(const size_t new_capacity) {
+    if (new_capacity > capacity_) {
+        BufferReallocation(new_capacity);
+    }
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::ShrinkToFit() {
+    if (!IsInline() && size_ != capacity_) {
+        BufferReallocation(size_);
+    }
+}
+
+// Swaps the heap buffers when both have one, otherwise goes through a temporary.
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Swap(SmallVector<T, N, Allocator> &other) {
+    if (&other == this) {
+        return;
+    }
+    if (IsInline() || other.IsInline()) {
+        SmallVector<T, N, Allocator> temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+        return;
+    }
+    std::swap(buffer_, other.buffer_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    if (AllocatorTraits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
+}
+
+template <class T, size_t N, class Allocator>
+Allocator SmallVector<T, N, Allocator>::GetAllocator() const {
+    return allocator_;
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::IsInline() const {
+    return buffer_ == reinterpret_cast<const T *>(inline_);
+}
+
+template <class T, size_t N, class Allocator>
+const T &SmallVector<T, N, Allocator>::operator[](size_t idx) const {
+    return buffer_[idx];
+}
+
+template <class T, size_t N, class Allocator>
+T &SmallVector<T, N, Allocator>::operator[](size_t idx) {
+    return buffer_[idx];
+}
+
+template <class T, size_t N, class Allocator>
+const T SmallVector<T, N, Allocator>::At(size_t idx) const {
+    if (idx >= size_) {
+        throw VectorOutOfRange{};
+    }
+    return buffer_[idx];
+}
+
+template <class T, size_t N, class Allocator>
+T &SmallVector<T, N, Allocator>::At(size_t idx) {
+    if (idx >= size_) {
+        throw VectorOutOfRange{};
+    }
+    return buffer_[idx];
+}
+
+template <class T, size_t N, class Allocator>
+T SmallVector<T, N, Allocator>::Front() const {
+    return buffer_[0];
+}
+
+template <class T, size_t N, class Allocator>
+T &SmallVector<T, N, Allocator>::Front() {
+    return buffer_[0];
+}
+
+template <class T, size_t N, class Allocator>
+T SmallVector<T, N, Allocator>::Back() const {
+    return buffer_[size_ - 1];
+}
+
+template <class T, size_t N, class Allocator>
+T &SmallVector<T, N, Allocator>::Back() {
+    return buffer_[size_ - 1];
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::Empty() const {
+    return size_ == 0;
+}
+
+template <class T, size_t N, class Allocator>
+size_t SmallVector<T, N, Allocator>::Size() const {
+    return size_;
+}
+
+template <class T, size_t N, class Allocator>
+size_t SmallVector<T, N, Allocator>::Capacity() const {
+    return capacity_;
+}
+
+template <class T, size_t N, class Allocator>
+const T *SmallVector<T, N, Allocator>::Data() const {
+    return buffer_;
+}
+
+template <class T, size_t N, class Allocator>
+T *SmallVector<T, N, Allocator>::Data() {
+    return buffer_;
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator<(const SmallVector<T, N, Allocator> &other) const {
+    return vector_detail::Less(buffer_, size_, other.buffer_, other.size_);
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator>(const SmallVector<T, N, Allocator> &other) const {
+    return (other < *this);
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator==(const SmallVector<T, N, Allocator> &other) const {
+    return vector_detail::Equal(buffer_, size_, other.buffer_, other.size_);
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator<=(const SmallVector<T, N, Allocator> &other) const {
+    return !(other < *this);
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator>=(const SmallVector<T, N, Allocator> &other) const {
+    return !(*this < other);
+}
+
+template <class T, size_t N, class Allocator>
+bool SmallVector<T, N, Allocator>::operator!=(const SmallVector<T, N, Allocator> &other) const {
+    return !(*this == other);
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::Fill(const size_t start, const size_t end, const T &value) {
+    if (start < end) {
+        vector_detail::Fill(buffer_ + start, end - start, value);
+    }
+}
+
+template <class T, size_t N, class Allocator>
+size_t SmallVector<T, N, Allocator>::Find(const T &value) const {
+    return vector_detail::Find(buffer_, size_, value);
+}
+
+template <class T, size_t N, class Allocator>
+size_t SmallVector<T, N, Allocator>::Count(const T &value) const {
+    return vector_detail::Count(buffer_, size_, value);
+}
+
+template <class T, size_t N, class Allocator>
+std::pair<T, T> SmallVector<T, N, Allocator>::MinMax() const {
+    if (size_ == 0) {
+        throw VectorOutOfRange{};
+    }
+    std::pair<T, T> result(buffer_[0], buffer_[0]);
+    vector_detail::MinMax(buffer_, size_, &result.first, &result.second);
+    return result;
+}
+
+template <class T, size_t N, class Allocator>
+size_t SmallVector<T, N, Allocator>::IncreaseCapacity() const {
+    return capacity_ * kIncreaseFactor;
+}
+
+template <class T, size_t N, class Allocator>
+void SmallVector<T, N, Allocator>::BufferReallocation(const size_t new_capacity) {
+    size_t kept = std::min(size_, new_capacity);
+    if (new_capacity <= N && IsInline()) {
+        vector_detail::Destroy(buffer_ + kept, size_ - kept);
+        size_ = kept;
+        return;
+    }
+    size_t capacity = std::max(new_capacity, N);
+    T *new_buffer = (new_capacity <= N) ? Inline() : AllocatorTraits::allocate(allocator_, capacity);
+    try {
+        vector_detail::Relocate(new_buffer, buffer_, kept);
+    } catch (...) {
+        Deallocate(new_buffer, capacity);
+        throw;
+    }
+    vector_detail::Destroy(buffer_ + kept, size_ - kept);
+    Deallocate(buffer_, capacity_);
+    buffer_ = new_buffer;
+    size_ = kept;
+    capacity_ = capacity;
+}
+
+#endif  // VECTOR_SMALL_VECTOR_H
@@ -1,6 +1,19 @@
 #ifndef VECTOR_VECTOR_H
 #define VECTOR_VECTOR_H
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
 
 class VectorOutOfRange : public std::out_of_range {
 public:
@@ -22,29 +35,463 @@ void Swap(T &a, T &b) {
     b = c;
 }
 
+// Types whose objects may be moved to another address with memcpy, leaving the source to be freed
+// without running its destructor. Specialize it for types that own their resources through pointers
+// to elsewhere, such as std::unique_ptr, so that Vector relocates them without moving element by element.
+template <class T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+namespace vector_detail {
+
+template <class T>
+void Destroy(T *buffer, const size_t size) {
+    if (!std::is_trivially_destructible<T>::value) {
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i].~T();
+        }
+    }
+}
+
+// Moves size elements into the raw storage at buffer_to, or copies those whose move may throw, so
+// that a failure leaves buffer_from as it was.
+template <class T>
+void MoveConstruct(T *buffer_to, T *buffer_from, const size_t size) {
+    size_t i = 0;
+    try {
+        for (; i < size; ++i) {
+            ::new (static_cast<void *>(buffer_to + i)) T(std::move_if_noexcept(buffer_from[i]));
+        }
+    } catch (...) {
+        Destroy(buffer_to, i);
+        throw;
+    }
+}
+
+// MoveConstruct that also ends the lifetime of the elements at buffer_from.
+template <class T>
+void Relocate(T *buffer_to, T *buffer_from, const size_t size) {
+    if (IsTriviallyRelocatable<T>::value) {
+        if (size != 0) {
+            memcpy(static_cast<void *>(buffer_to), static_cast<const void *>(buffer_from), size * sizeof(T));
+        }
+        return;
+    }
+    MoveConstruct(buffer_to, buffer_from, size);
+    Destroy(buffer_from, size);
+}
+
+// Shifts size elements by memmove, only for IsTriviallyRelocatable types.
+template <class T>
+void RelocateOverlapping(T *buffer_to, T *buffer_from, const size_t size) {
+    if (size != 0) {
+        memmove(static_cast<void *>(buffer_to), static_cast<const void *>(buffer_from), size * sizeof(T));
+    }
+}
+
+// Category of an iterator type, void for types that are not iterators.
+template <class Iterator, class = void>
+struct IteratorCategory {
+    using type = void;
+};
+
+template <class Iterator>
+struct IteratorCategory<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category>> {
+    using type = typename std::iterator_traits<Iterator>::iterator_category;
+};
+
+template <class Iterator>
+using IsInputIterator = std::is_convertible<typename IteratorCategory<Iterator>::type, std::input_iterator_tag>;
+
+// Whether a pointer points into the size elements at buffer. Other iterators give false whatever
+// they refer to, so callers must not rely on it unless the iterator is a pointer.
+template <class Iterator, class T>
+bool PointsInto(const Iterator &, const T *, const size_t) {
+    return false;
+}
+
+template <class T>
+bool PointsInto(const T *pointer, const T *buffer, const size_t size) {
+    return std::less_equal<const T *>()(buffer, pointer) && std::less<const T *>()(pointer, buffer + size);
+}
+
+template <class T>
+bool PointsInto(T *pointer, const T *buffer, const size_t size) {
+    return PointsInto(static_cast<const T *>(pointer), buffer, size);
+}
+
+// Whether an allocator can resize a buffer itself through reallocate(pointer, old_count, new_count),
+// which returns the new buffer and leaves the old one alone if it throws.
+template <class Allocator, class = void>
+struct HasReallocate : std::false_type {};
+
+template <class Allocator>
+struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator &>().reallocate(
+                                    std::declval<typename Allocator::value_type *>(), size_t(), size_t()))>>
+    : std::true_type {};
+
+}  // namespace vector_detail
+
+// Scans, comparisons and fills of at least min_elements arithmetic elements are split into one
+// contiguous chunk per thread once threads is above one; the calling thread takes the first chunk.
+struct VectorParallelism {
+    size_t threads = 0;
+    size_t min_elements = static_cast<size_t>(1) << 22;
+};
+
+inline VectorParallelism &GetVectorParallelism() {
+    static VectorParallelism parallelism;
+    return parallelism;
+}
+
+namespace vector_detail {
+
+template <class T>
+size_t ParallelChunks(const size_t size) {
+    const VectorParallelism &parallelism = GetVectorParallelism();
+    // Every chunk gets at least kSimdMinElements elements, so short arrays stay in one piece.
+    size_t chunks = std::min(parallelism.threads, size / kSimdMinElements);
+    if (!std::is_arithmetic<T>::value || chunks < 2 || size < parallelism.min_elements) {
+        return 1;
+    }
+    return chunks;
+}
+
+// Runs function(chunk, begin, end) for each of chunks contiguous parts of [0, size). A chunk whose
+// thread cannot be started runs on the calling thread.
+template <class Function>
+void RunChunks(const size_t size, const size_t chunks, Function function) {
+    std::unique_ptr<std::thread[]> threads(new std::thread[chunks - 1]);
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        size_t begin = size / chunks * chunk;
+        size_t end = (chunk + 1 == chunks) ? size : begin + size / chunks;
+        try {
+            threads[chunk - 1] = std::thread(function, chunk, begin, end);
+        } catch (const std::system_error &) {
+            function(chunk, begin, end);
+        }
+    }
+    function(static_cast<size_t>(0), static_cast<size_t>(0), size / chunks);
+    for (size_t i = 0; i + 1 < chunks; ++i) {
+        if (threads[i].joinable()) {
+            threads[i].join();
+        }
+    }
+}
+
+template <class T>
+size_t FindSequential(const T *buffer, const size_t size, const T &value) {
+#if VECTOR_HAS_AVX2_KERNELS
+    if constexpr (IsSimdInteger<T>::value) {
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return FindIntegerAvx2(buffer, size, value);
+        }
+    } else if constexpr (IsSimdFloat<T>::value) {
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return FindFloatAvx2(buffer, size, value);
+        }
+    }
+#endif
+    for (size_t i = 0; i < size; ++i) {
+        if (buffer[i] == value) {
+            return i;
+        }
+    }
+    return size;
+}
+
+template <class T>
+size_t CountSequential(const T *buffer, const size_t size, const T &value) {
+#if VECTOR_HAS_AVX2_KERNELS
+    if constexpr (IsSimdInteger<T>::value) {
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return CountIntegerAvx2(buffer, size, value);
+        }
+    } else if constexpr (IsSimdFloat<T>::value) {
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return CountFloatAvx2(buffer, size, value);
+        }
+    }
+#endif
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += (buffer[i] == value) ? 1 : 0;
+    }
+    return count;
+}
+
+// Index of the first element where first and second differ, size if there is none. With NOrdered,
+// elements differ when one is less than the other, so that NaNs compare like equal ones; otherwise
+// when they are !=. Only the operators of the chosen comparison are required of T.
+template <bool NOrdered, class T>
+size_t MismatchSequential(const T *first, const T *second, const size_t size) {
+    if constexpr (IsSimdInteger<T>::value) {
+#if VECTOR_HAS_AVX2_KERNELS
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return MismatchIntegerAvx2(first, second, size);
+        }
+#endif
+        if (size == 0 || memcmp(first, second, size * sizeof(T)) == 0) {
+            return size;
+        }
+    } else if constexpr (IsSimdFloat<T>::value) {
+#if VECTOR_HAS_AVX2_KERNELS
+        if (size >= kSimdMinElements && HasAvx2()) {
+            return MismatchFloatAvx2<NOrdered>(first, second, size);
+        }
+#endif
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if constexpr (NOrdered) {
+            if (first[i] < second[i] || first[i] > second[i]) {
+                return i;
+            }
+        } else if (first[i] != second[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// Smallest and largest of size > 0 elements.
+template <class T>
+void MinMaxSequential(const T *buffer, const size_t size, T *min, T *max) {
+#if VECTOR_HAS_AVX2_KERNELS
+    if constexpr (HasSimdMinMax<T>::value) {
+        if (size >= kSimdMinElements && HasAvx2()) {
+            MinMaxAvx2(buffer, size, min, max);
+            return;
+        }
+    }
+#endif
+    size_t low = 0;
+    size_t high = 0;
+    for (size_t i = 1; i < size; ++i) {
+        if (buffer[i] < buffer[low]) {
+            low = i;
+        }
+        if (buffer[high] < buffer[i]) {
+            high = i;
+        }
+    }
+    *min = buffer[low];
+    *max = buffer[high];
+}
+
+template <class T>
+void FillSequential(T *buffer, const size_t size, const T &value) {
+    if constexpr (std::is_arithmetic<T>::value) {
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        if (std::all_of(bytes, bytes + sizeof(T), [&](const unsigned char byte) { return byte == bytes[0]; })) {
+            memset(static_cast<void *>(buffer), bytes[0], size * sizeof(T));
+            return;
+        }
+    }
+    std::fill(buffer, buffer + size, value);
+}
+
+// The functions below pick SIMD kernels for arithmetic elements and spread the work over threads
+// according to GetVectorParallelism(); they are shared by the containers of this directory.
+template <class T>
+size_t Find(const T *buffer, const size_t size, const T &value) {
+    size_t chunks = ParallelChunks<T>(size);
+    if (chunks == 1) {
+        return FindSequential(buffer, size, value);
+    }
+    std::unique_ptr<size_t[]> found(new size_t[chunks]);
+    RunChunks(size, chunks, [&](const size_t chunk, const size_t begin, const size_t end) {
+        size_t i = FindSequential(buffer + begin, end - begin, value);
+        found[chunk] = (i == end - begin) ? size : begin + i;
+    });
+    return *std::min_element(found.get(), found.get() + chunks);
+}
+
+template <class T>
+size_t Count(const T *buffer, const size_t size, const T &value) {
+    size_t chunks = ParallelChunks<T>(size);
+    if (chunks == 1) {
+        return CountSequential(buffer, size, value);
+    }
+    std::unique_ptr<size_t[]> counts(new size_t[chunks]);
+    RunChunks(size, chunks, [&](const size_t chunk, const size_t begin, const size_t end) {
+        counts[chunk] = CountSequential(buffer + begin, end - begin, value);
+    });
+    return std::accumulate(counts.get(), counts.get() + chunks, static_cast<size_t>(0));
+}
+
+template <bool NOrdered, class T>
+size_t Mismatch(const T *first, const T *second, const size_t size) {
+    size_t chunks = ParallelChunks<T>(size);
+    if (chunks == 1) {
+        return MismatchSequential<NOrdered>(first, second, size);
+    }
+    std::unique_ptr<size_t[]> found(new size_t[chunks]);
+    RunChunks(size, chunks, [&](const size_t chunk, const size_t begin, const size_t end) {
+        size_t i = MismatchSequential<NOrdered>(first + begin, second + begin, end - begin);
+        found[chunk] = (i == end - begin) ? size : begin + i;
+    });
+    return *std::min_element(found.get(), found.get() + chunks);
+}
+
+// With NaNs among floating point elements, which of them count as smallest or largest is unspecified.
+template <class T>
+void MinMax(const T *buffer, const size_t size, T *min, T *max) {
+    size_t chunks = ParallelChunks<T>(size);
+    if (chunks == 1) {
+        MinMaxSequential(buffer, size, min, max);
+        return;
+    }
+    // Only arithmetic elements get here, so the arrays need no constructors.
+    std::unique_ptr<T[]> mins(new T[chunks]);
+    std::unique_ptr<T[]> maxes(new T[chunks]);
+    RunChunks(size, chunks, [&](const size_t chunk, const size_t begin, const size_t end) {
+        MinMaxSequential(buffer + begin, end - begin, &mins[chunk], &maxes[chunk]);
+    });
+    T unused;
+    MinMaxSequential(mins.get(), chunks, min, &unused);
+    MinMaxSequential(maxes.get(), chunks, &unused, max);
+}
+
+template <class T>
+void Fill(T *buffer, const size_t size, const T &value) {
+    size_t chunks = ParallelChunks<T>(size);
+    if (chunks == 1) {
+        FillSequential(buffer, size, value);
+        return;
+    }
+    const T copy = value;
+    RunChunks(size, chunks, [&](const size_t, const size_t begin, const size_t end) {
+        FillSequential(buffer + begin, end - begin, copy);
+    });
+}
+
+// Lexicographic comparison of two arrays.
+template <class T>
+bool Less(const T *first, const size_t first_size, const T *second, const size_t second_size) {
+    size_t end = std::min(first_size, second_size);
+    size_t i = Mismatch<true>(first, second, end);
+    return (i < end) ? first[i] < second[i] : first_size < second_size;
+}
+
 template <class T>
+bool Equal(const T *first, const size_t first_size, const T *second, const size_t second_size) {
+    return first_size == second_size && Mismatch<false>(first, second, first_size) == first_size;
+}
+
+}  // namespace vector_detail
+
+// Growth policies give the capacity Vector grows to from capacity when it needs room for at least
+// required elements of element_size bytes.
+
+// Grows the capacity by the factor NNumerator / NDenominator.
+template <size_t NNumerator, size_t NDenominator>
+struct FactorGrowth {
+    static size_t NextCapacity(const size_t capacity, const size_t required, const size_t /* element_size */) {
+        size_t grown = capacity / NDenominator * NNumerator + capacity % NDenominator * NNumerator / NDenominator;
+        return std::max(std::max(grown, required), static_cast<size_t>(1));
+    }
+};
+
+using DoublingGrowth = FactorGrowth<2, 1>;
+using OneAndHalfGrowth = FactorGrowth<3, 2>;
+
+// Rounds the buffers of Base up to the size classes of jemalloc, four per power of two, so that the
+// capacity takes up the slack the allocator would leave unused anyway.
+template <class Base = DoublingGrowth>
+struct SizeClassGrowth {
+    static size_t NextCapacity(const size_t capacity, const size_t required, const size_t element_size) {
+        size_t bytes = Base::NextCapacity(capacity, required, element_size) * element_size;
+        size_t spacing = 16;
+        if (bytes > 128) {
+            size_t log = 0;
+            while ((static_cast<size_t>(2) << log) < bytes) {
+                ++log;
+            }
+            spacing = static_cast<size_t>(1) << (log - 2);
+        }
+        bytes = (bytes + spacing - 1) / spacing * spacing;
+        return bytes / element_size;
+    }
+};
+
+// Growing Resize and range insertions follow GrowthPolicy like PushBack does, Reserve and ShrinkToFit
+// set the capacity they are given.
+template <class T, class Allocator = std::allocator<T>, class GrowthPolicy = DoublingGrowth>
 class Vector {
 private:
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+    // Raw storage for capacity_ elements, of which the first size_ are constructed.
     T *buffer_;
     size_t size_;
     size_t capacity_;
-    const static size_t kIncreaseFactor = 2;
+    Allocator allocator_;
+    static constexpr bool kMoveAssignmentNoexcept =
+        AllocatorTraits::propagate_on_container_move_assignment::value || AllocatorTraits::is_always_equal::value;
+    // Buffers of trivially relocatable elements are resized by the allocator when it can, see
+    // PageAllocator in allocators.h.
+    static constexpr bool kReallocates =
+        IsTriviallyRelocatable<T>::value && vector_detail::HasReallocate<Allocator>::value;
+
+    T *Allocate(const size_t capacity);
+    size_t GrownCapacity(const size_t required) const;
+    void Deallocate(T *buffer, const size_t capacity);
+    void SwapStorage(Vector<T, Allocator, GrowthPolicy> &other);
+    template <class Construct>
+    void Grow(const size_t new_capacity, const size_t position, const size_t constructed, Construct construct);
+    template <class InputIt>
+    void InsertRange(const size_t position, InputIt first, InputIt last, std::input_iterator_tag);
+    template <class ForwardIt>
+    void InsertRange(const size_t position, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
 
 public:
     Vector();
-    explicit Vector(const size_t size);
-    Vector(const size_t size, const T &value);
-    Vector(const Vector<T> &other);
-    Vector<T> &operator=(const Vector<T> &other);
+    explicit Vector(const Allocator &allocator);
+    explicit Vector(const size_t size, const Allocator &allocator = Allocator());
+    Vector(const size_t size, const T &value, const Allocator &allocator = Allocator());
+    template <class InputIt, class = typename std::enable_if<vector_detail::IsInputIterator<InputIt>::value>::type>
+    Vector(InputIt first, InputIt last, const Allocator &allocator = Allocator());
+    Vector(std::initializer_list<T> values, const Allocator &allocator = Allocator());
+    Vector(const Vector<T, Allocator, GrowthPolicy> &other);
+    Vector(const Vector<T, Allocator, GrowthPolicy> &other, const Allocator &allocator);
+    Vector(Vector<T, Allocator, GrowthPolicy> &&other) noexcept;
+    Vector<T, Allocator, GrowthPolicy> &operator=(const Vector<T, Allocator, GrowthPolicy> &other);
+    // Takes the buffer of other unless the allocators differ and do not propagate on move assignment,
+    // in which case the elements are moved one by one into storage of this allocator.
+    Vector<T, Allocator, GrowthPolicy> &operator=(Vector<T, Allocator, GrowthPolicy> &&other) noexcept(
+        kMoveAssignmentNoexcept);
     ~Vector();
     void Clear();
     void PushBack(const T &value);
-    T &PopBack();
+    void PushBack(T &&value);
+    // Constructs the new last element in place from args, which may refer to an element of the vector.
+    template <class... Args>
+    T &EmplaceBack(Args &&... args);
+    // Removes the last element and returns its value.
+    T PopBack();
+    // The range operations below reallocate at most once when the length of the range is known up
+    // front, that is for forward iterators. Their ranges may be part of the vector itself.
+    template <class InputIt, class = typename std::enable_if<vector_detail::IsInputIterator<InputIt>::value>::type>
+    void Append(InputIt first, InputIt last);
+    void Append(std::initializer_list<T> values);
+    // Inserting at a position beyond Size() or erasing outside of the elements throws VectorOutOfRange.
+    template <class... Args>
+    T &Emplace(const size_t position, Args &&... args);
+    void Insert(const size_t position, const T &value);
+    void Insert(const size_t position, T &&value);
+    template <class InputIt, class = typename std::enable_if<vector_detail::IsInputIterator<InputIt>::value>::type>
+    void Insert(const size_t position, InputIt first, InputIt last);
+    void Insert(const size_t position, std::initializer_list<T> values);
+    void Erase(const size_t position);
+    void Erase(const size_t first, const size_t last);
+    // Moves the last element into position instead of shifting the ones after it, so the order is lost.
+    void SwapErase(const size_t position);
     void Resize(const size_t new_size);
     void Resize(const size_t new_size, const T &value);
     void Reserve(const size_t new_capacity);
     void ShrinkToFit();
-    void Swap(Vector<T> &other);
+    // Swaps the allocators too if they propagate on swap, otherwise they must be equal.
+    void Swap(Vector<T, Allocator, GrowthPolicy> &other);
+    Allocator GetAllocator() const;
     const T &operator[](size_t idx) const;
     T &operator[](size_t idx);
     const T At(size_t idx) const;
@@ -58,253 +505,605 @@ public:
     size_t Capacity() const;
     const T *Data() const;
     T *Data();
-    bool operator<(const Vector<T> &other) const;
-    bool operator>(const Vector<T> &other) const;
-    bool operator==(const Vector<T> &other) const;
-    bool operator<=(const Vector<T> &other) const;
-    bool operator>=(const Vector<T> &other) const;
-    bool operator!=(const Vector<T> &other) const;
+    bool operator<(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    bool operator>(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    bool operator==(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    bool operator<=(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    bool operator>=(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    bool operator!=(const Vector<T, Allocator, GrowthPolicy> &other) const;
+    // Assigns value to the constructed elements from start to end.
     void Fill(const size_t start, const size_t end, const T &value);
+    // Index of the first element equal to value, Size() if there is none.
+    size_t Find(const T &value) const;
+    size_t Count(const T &value) const;
+    // Smallest and largest element; throws VectorOutOfRange if the vector is empty.
+    std::pair<T, T> MinMax() const;
+    // Capacity the growth policy gives for one more element.
     size_t IncreaseCapacity() const;
+    // Moves the elements to a new buffer of new_capacity, dropping those that do not fit.
     void BufferReallocation(const size_t new_capacity);
 };
 
-template <class T>
-Vector<T>::Vector() : buffer_(nullptr), size_(0), capacity_(0) {
+template <class T, class Allocator, class GrowthPolicy>
+T *Vector<T, Allocator, GrowthPolicy>::Allocate(const size_t capacity) {
+    return (capacity == 0) ? nullptr : AllocatorTraits::allocate(allocator_, capacity);
 }
 
-template <class T>
-Vector<T>::Vector(const size_t size) : size_(size), capacity_(size) {
-    buffer_ = new T[capacity_];
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Deallocate(T *buffer, const size_t capacity) {
+    if (buffer != nullptr) {
+        AllocatorTraits::deallocate(allocator_, buffer, capacity);
+    }
 }
 
-template <class T>
-Vector<T>::Vector(const size_t size, const T &value) : size_(size), capacity_(size) {
-    buffer_ = new T[capacity_];
-    Fill(0, size_, value);
+// Swaps everything, the allocators included, whatever they say about propagation.
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::SwapStorage(Vector<T, Allocator, GrowthPolicy> &other) {
+    using std::swap;
+    swap(buffer_, other.buffer_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(allocator_, other.allocator_);
 }
 
-template <class T>
-Vector<T>::Vector(const Vector<T> &other) : size_(other.size_), capacity_(other.capacity_) {
-    buffer_ = new T[capacity_];
-    Copy(buffer_, other.buffer_, size_);
+// Switches to a new buffer of new_capacity >= size_ + constructed with room for constructed elements
+// before the one at position. construct(gap) builds them before the current elements move, so it may
+// still read those; it must clean up after itself if it throws.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+void Vector<T, Allocator, GrowthPolicy>::Grow(const size_t new_capacity, const size_t position,
+                                              const size_t constructed, Construct construct) {
+    T *new_buffer = Allocate(new_capacity);
+    try {
+        construct(new_buffer + position);
+    } catch (...) {
+        Deallocate(new_buffer, new_capacity);
+        throw;
+    }
+    T *tail = new_buffer + position + constructed;
+    if (IsTriviallyRelocatable<T>::value) {
+        vector_detail::Relocate(new_buffer, buffer_, position);
+        vector_detail::Relocate(tail, buffer_ + position, size_ - position);
+    } else {
+        try {
+            vector_detail::MoveConstruct(new_buffer, buffer_, position);
+            try {
+                vector_detail::MoveConstruct(tail, buffer_ + position, size_ - position);
+            } catch (...) {
+                vector_detail::Destroy(new_buffer, position);
+                throw;
+            }
+        } catch (...) {
+            vector_detail::Destroy(new_buffer + position, constructed);
+            Deallocate(new_buffer, new_capacity);
+            throw;
+        }
+        vector_detail::Destroy(buffer_, size_);
+    }
+    Deallocate(buffer_, capacity_);
+    buffer_ = new_buffer;
+    capacity_ = new_capacity;
 }
 
-template <class T>
-Vector<T> &Vector<T>::operator=(const Vector<T> &other) {
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector() : buffer_(nullptr), size_(0), capacity_(0) {
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Allocator &allocator)
+    : buffer_(nullptr), size_(0), capacity_(0), allocator_(allocator) {
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const size_t size, const Allocator &allocator)
+    : buffer_(nullptr), size_(size), capacity_(size), allocator_(allocator) {
+    buffer_ = Allocate(capacity_);
+    try {
+        std::uninitialized_value_construct_n(buffer_, size_);
+    } catch (...) {
+        Deallocate(buffer_, capacity_);
+        throw;
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const size_t size, const T &value, const Allocator &allocator)
+    : buffer_(nullptr), size_(size), capacity_(size), allocator_(allocator) {
+    buffer_ = Allocate(capacity_);
+    try {
+        std::uninitialized_fill_n(buffer_, size_, value);
+    } catch (...) {
+        Deallocate(buffer_, capacity_);
+        throw;
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class InputIt, class>
+Vector<T, Allocator, GrowthPolicy>::Vector(InputIt first, InputIt last, const Allocator &allocator)
+    : Vector(allocator) {
+    Append(first, last);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(std::initializer_list<T> values, const Allocator &allocator)
+    : Vector(allocator) {
+    Append(values.begin(), values.end());
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Vector<T, Allocator, GrowthPolicy> &other)
+    : Vector(other, AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(const Vector<T, Allocator, GrowthPolicy> &other, const Allocator &allocator)
+    : buffer_(nullptr), size_(other.size_), capacity_(other.capacity_), allocator_(allocator) {
+    buffer_ = Allocate(capacity_);
+    try {
+        std::uninitialized_copy_n(other.buffer_, size_, buffer_);
+    } catch (...) {
+        Deallocate(buffer_, capacity_);
+        throw;
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(Vector<T, Allocator, GrowthPolicy> &&other) noexcept
+    : buffer_(other.buffer_), size_(other.size_), capacity_(other.capacity_), allocator_(std::move(other.allocator_)) {
+    other.buffer_ = nullptr;
+    other.size_ = other.capacity_ = 0;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy> &Vector<T, Allocator, GrowthPolicy>::operator=(
+    const Vector<T, Allocator, GrowthPolicy> &other) {
     if (&other != this) {
-        BufferReallocation(other.capacity_);
+        Vector<T, Allocator, GrowthPolicy> copy(
+            other, AllocatorTraits::propagate_on_container_copy_assignment::value ? other.allocator_ : allocator_);
+        SwapStorage(copy);
+    }
+    return *this;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy> &Vector<T, Allocator, GrowthPolicy>::operator=(
+    Vector<T, Allocator, GrowthPolicy> &&other) noexcept(kMoveAssignmentNoexcept) {
+    if (&other == this) {
+        return *this;
+    }
+    if (AllocatorTraits::propagate_on_container_move_assignment::value || allocator_ == other.allocator_) {
+        vector_detail::Destroy(buffer_, size_);
+        Deallocate(buffer_, capacity_);
+        if (AllocatorTraits::propagate_on_container_move_assignment::value) {
+            allocator_ = std::move(other.allocator_);
+        }
+        buffer_ = other.buffer_;
         size_ = other.size_;
-        Copy(buffer_, other.buffer_, size_);
+        capacity_ = other.capacity_;
+        other.buffer_ = nullptr;
+        other.size_ = other.capacity_ = 0;
+    } else {
+        Vector<T, Allocator, GrowthPolicy> moved(allocator_);
+        moved.Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            moved.EmplaceBack(std::move_if_noexcept(other.buffer_[i]));
+        }
+        SwapStorage(moved);
+        other.Clear();
     }
     return *this;
 }
 
-template <class T>
-Vector<T>::~Vector() {
-    delete[] buffer_;
+template <class T, class Allocator, class GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::~Vector() {
+    vector_detail::Destroy(buffer_, size_);
+    Deallocate(buffer_, capacity_);
 }
 
-template <class T>
-void Vector<T>::Clear() {
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Clear() {
+    vector_detail::Destroy(buffer_, size_);
     size_ = 0;
 }
 
-template <class T>
-void Vector<T>::PushBack(const T &value) {
-    if (size_ == capacity_) {
-        BufferReallocation(IncreaseCapacity());
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::PushBack(const T &value) {
+    EmplaceBack(value);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::PushBack(T &&value) {
+    EmplaceBack(std::move(value));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class... Args>
+T &Vector<T, Allocator, GrowthPolicy>::EmplaceBack(Args &&... args) {
+    if (size_ < capacity_) {
+        ::new (static_cast<void *>(buffer_ + size_)) T(std::forward<Args>(args)...);
+    } else if constexpr (kReallocates) {
+        // The buffer may move, so the new element is built aside in case args refer to an element.
+        alignas(T) unsigned char storage[sizeof(T)];
+        T *value = ::new (static_cast<void *>(storage)) T(std::forward<Args>(args)...);
+        try {
+            BufferReallocation(IncreaseCapacity());
+        } catch (...) {
+            value->~T();
+            throw;
+        }
+        vector_detail::Relocate(buffer_ + size_, value, 1);
+    } else {
+        Grow(IncreaseCapacity(), size_, 1,
+             [&](T *position) { ::new (static_cast<void *>(position)) T(std::forward<Args>(args)...); });
     }
-    buffer_[size_] = value;
     ++size_;
+    return buffer_[size_ - 1];
 }
 
-template <class T>
-T &Vector<T>::PopBack() {
-    T &result = buffer_[size_];
+template <class T, class Allocator, class GrowthPolicy>
+T Vector<T, Allocator, GrowthPolicy>::PopBack() {
+    T result(std::move(buffer_[size_ - 1]));
     --size_;
+    buffer_[size_].~T();
     return result;
 }
 
-template <class T>
-void Vector<T>::Resize(const size_t new_size) {
+template <class T, class Allocator, class GrowthPolicy>
+template <class InputIt, class>
+void Vector<T, Allocator, GrowthPolicy>::Append(InputIt first, InputIt last) {
+    InsertRange(size_, first, last, typename vector_detail::IteratorCategory<InputIt>::type());
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Append(std::initializer_list<T> values) {
+    Append(values.begin(), values.end());
+}
+
+// Goes through EmplaceBack, which takes care of args that refer to elements, and rotates the new
+// element into place.
+template <class T, class Allocator, class GrowthPolicy>
+template <class... Args>
+T &Vector<T, Allocator, GrowthPolicy>::Emplace(const size_t position, Args &&... args) {
+    if (position > size_) {
+        throw VectorOutOfRange{};
+    }
+    EmplaceBack(std::forward<Args>(args)...);
+    std::rotate(buffer_ + position, buffer_ + size_ - 1, buffer_ + size_);
+    return buffer_[position];
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Insert(const size_t position, const T &value) {
+    Emplace(position, value);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Insert(const size_t position, T &&value) {
+    Emplace(position, std::move(value));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class InputIt, class>
+void Vector<T, Allocator, GrowthPolicy>::Insert(const size_t position, InputIt first, InputIt last) {
+    if (position > size_) {
+        throw VectorOutOfRange{};
+    }
+    InsertRange(position, first, last, typename vector_detail::IteratorCategory<InputIt>::type());
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Insert(const size_t position, std::initializer_list<T> values) {
+    Insert(position, values.begin(), values.end());
+}
+
+// A single pass range of unknown length is appended and then rotated into place.
+template <class T, class Allocator, class GrowthPolicy>
+template <class InputIt>
+void Vector<T, Allocator, GrowthPolicy>::InsertRange(const size_t position, InputIt first, InputIt last,
+                                                     std::input_iterator_tag) {
+    size_t old_size = size_;
+    for (; first != last; ++first) {
+        EmplaceBack(*first);
+    }
+    std::rotate(buffer_ + position, buffer_ + old_size, buffer_ + size_);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class ForwardIt>
+void Vector<T, Allocator, GrowthPolicy>::InsertRange(const size_t position, ForwardIt first, ForwardIt last,
+                                                     std::forward_iterator_tag) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    if (count == 0) {
+        return;
+    }
+    if (size_ + count > capacity_) {
+        Grow(GrownCapacity(size_ + count), position, count,
+             [&](T *gap) { std::uninitialized_copy(first, last, gap); });
+        size_ += count;
+    } else if (IsTriviallyRelocatable<T>::value && std::is_pointer<ForwardIt>::value &&
+               !vector_detail::PointsInto(first, buffer_, size_)) {
+        // Shifting the elements first is only safe when the range cannot be among them, which can be
+        // ruled out for pointers alone.
+        T *gap = buffer_ + position;
+        vector_detail::RelocateOverlapping(gap + count, gap, size_ - position);
+        try {
+            std::uninitialized_copy(first, last, gap);
+        } catch (...) {
+            vector_detail::RelocateOverlapping(gap, gap + count, size_ - position);
+            throw;
+        }
+        size_ += count;
+    } else {
+        // The copies go to the free space first, where they cannot overlap the range.
+        std::uninitialized_copy(first, last, buffer_ + size_);
+        size_ += count;
+        std::rotate(buffer_ + position, buffer_ + size_ - count, buffer_ + size_);
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Erase(const size_t position) {
+    Erase(position, position + 1);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Erase(const size_t first, const size_t last) {
+    if (first > last || last > size_) {
+        throw VectorOutOfRange{};
+    }
+    size_t count = last - first;
+    if (count == 0) {
+        return;
+    }
+    if (IsTriviallyRelocatable<T>::value) {
+        vector_detail::Destroy(buffer_ + first, count);
+        vector_detail::RelocateOverlapping(buffer_ + first, buffer_ + last, size_ - last);
+    } else {
+        std::move(buffer_ + last, buffer_ + size_, buffer_ + first);
+        vector_detail::Destroy(buffer_ + size_ - count, count);
+    }
+    size_ -= count;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::SwapErase(const size_t position) {
+    if (position >= size_) {
+        throw VectorOutOfRange{};
+    }
+    if (position != size_ - 1) {
+        buffer_[position] = std::move(buffer_[size_ - 1]);
+    }
+    --size_;
+    buffer_[size_].~T();
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Resize(const size_t new_size) {
     if (new_size > capacity_) {
-        BufferReallocation(new_size);
+        BufferReallocation(GrownCapacity(new_size));
+    }
+    if (new_size > size_) {
+        std::uninitialized_value_construct_n(buffer_ + size_, new_size - size_);
+    } else {
+        vector_detail::Destroy(buffer_ + new_size, size_ - new_size);
     }
     size_ = new_size;
 }
 
-template <class T>
-void Vector<T>::Resize(const size_t new_size, const T &value) {
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Resize(const size_t new_size, const T &value) {
     if (new_size > capacity_) {
-        BufferReallocation(new_size);
-        Fill(size_, new_size, value);
-        size_ = new_size;
-    } else {
-        if (new_size > size_) {
-            Fill(size_, new_size, value);
+        // value may be one of the elements, so the new ones are built before the old ones move.
+        if constexpr (kReallocates) {
+            T copy(value);
+            BufferReallocation(GrownCapacity(new_size));
+            std::uninitialized_fill_n(buffer_ + size_, new_size - size_, copy);
+        } else {
+            Grow(GrownCapacity(new_size), size_, new_size - size_,
+                 [&](T *position) { std::uninitialized_fill_n(position, new_size - size_, value); });
         }
-        size_ = new_size;
+    } else if (new_size > size_) {
+        std::uninitialized_fill_n(buffer_ + size_, new_size - size_, value);
+    } else {
+        vector_detail::Destroy(buffer_ + new_size, size_ - new_size);
     }
+    size_ = new_size;
 }
 
-template <class T>
-void Vector<T>::Reserve(const size_t new_capacity) {
-    BufferReallocation(std::max(capacity_, new_capacity));
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Reserve(const size_t new_capacity) {
+    if (new_capacity > capacity_) {
+        BufferReallocation(new_capacity);
+    }
 }
 
-template <class T>
-void Vector<T>::ShrinkToFit() {
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::ShrinkToFit() {
     if (size_ != capacity_) {
         BufferReallocation(size_);
     }
 }
 
-template <class T>
-void Vector<T>::Swap(Vector<T> &other) {
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Swap(Vector<T, Allocator, GrowthPolicy> &other) {
     std::swap(buffer_, other.buffer_);
-    ::Swap(capacity_, other.capacity_);
-    ::Swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    if (AllocatorTraits::propagate_on_container_swap::value) {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+    }
 }
 
-template <class T>
-const T &Vector<T>::operator[](size_t idx) const {
+template <class T, class Allocator, class GrowthPolicy>
+Allocator Vector<T, Allocator, GrowthPolicy>::GetAllocator() const {
+    return allocator_;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+const T &Vector<T, Allocator, GrowthPolicy>::operator[](size_t idx) const {
     return buffer_[idx];
 }
 
-template <class T>
-T &Vector<T>::operator[](size_t idx) {
+template <class T, class Allocator, class GrowthPolicy>
+T &Vector<T, Allocator, GrowthPolicy>::operator[](size_t idx) {
     return buffer_[idx];
 }
 
-template <class T>
-const T Vector<T>::At(size_t idx) const {
+template <class T, class Allocator, class GrowthPolicy>
+const T Vector<T, Allocator, GrowthPolicy>::At(size_t idx) const {
     if (idx >= size_) {
         throw VectorOutOfRange{};
     }
     return buffer_[idx];
 }
 
-template <class T>
-T &Vector<T>::At(size_t idx) {
+template <class T, class Allocator, class GrowthPolicy>
+T &Vector<T, Allocator, GrowthPolicy>::At(size_t idx) {
     if (idx >= size_) {
         throw VectorOutOfRange{};
     }
     return buffer_[idx];
 }
 
-template <class T>
-T Vector<T>::Front() const {
+template <class T, class Allocator, class GrowthPolicy>
+T Vector<T, Allocator, GrowthPolicy>::Front() const {
     return buffer_[0];
 }
 
-template <class T>
-T &Vector<T>::Front() {
+template <class T, class Allocator, class GrowthPolicy>
+T &Vector<T, Allocator, GrowthPolicy>::Front() {
     return buffer_[0];
 }
 
-template <class T>
-T Vector<T>::Back() const {
+template <class T, class Allocator, class GrowthPolicy>
+T Vector<T, Allocator, GrowthPolicy>::Back() const {
     return buffer_[size_ - 1];
 }
 
-template <class T>
-T &Vector<T>::Back() {
+template <class T, class Allocator, class GrowthPolicy>
+T &Vector<T, Allocator, GrowthPolicy>::Back() {
     return buffer_[size_ - 1];
 }
 
-template <class T>
-bool Vector<T>::Empty() const {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::Empty() const {
     return size_ == 0;
 }
 
-template <class T>
-size_t Vector<T>::Size() const {
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Size() const {
     return size_;
 }
 
-template <class T>
-size_t Vector<T>::Capacity() const {
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Capacity() const {
     return capacity_;
 }
 
-template <class T>
-const T *Vector<T>::Data() const {
-    return &(buffer_[0]);
+template <class T, class Allocator, class GrowthPolicy>
+const T *Vector<T, Allocator, GrowthPolicy>::Data() const {
+    return buffer_;
 }
 
-template <class T>
-T *Vector<T>::Data() {
-    return &(buffer_[0]);
+template <class T, class Allocator, class GrowthPolicy>
+T *Vector<T, Allocator, GrowthPolicy>::Data() {
+    return buffer_;
 }
 
-template <class T>
-bool Vector<T>::operator<(const Vector<T> &other) const {
-    size_t end = std::min(size_, other.size_);
-    for (size_t i = 0; i < end; ++i) {
-        if (buffer_[i] < other.buffer_[i]) {
-            return true;
-        }
-        if (buffer_[i] > other.buffer_[i]) {
-            return false;
-        }
-    }
-    return (size_ < other.size_);
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator<(const Vector<T, Allocator, GrowthPolicy> &other) const {
+    return vector_detail::Less(buffer_, size_, other.buffer_, other.size_);
 }
 
-template <class T>
-bool Vector<T>::operator>(const Vector<T> &other) const {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator>(const Vector<T, Allocator, GrowthPolicy> &other) const {
     return (other < *this);
 }
 
-template <class T>
-bool Vector<T>::operator==(const Vector<T> &other) const {
-    if (size_ != other.size_) {
-        return false;
-    }
-    for (size_t i = 0; i < size_; ++i) {
-        if (buffer_[i] != other.buffer_[i]) {
-            return false;
-        }
-    }
-    return true;
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator==(const Vector<T, Allocator, GrowthPolicy> &other) const {
+    return vector_detail::Equal(buffer_, size_, other.buffer_, other.size_);
 }
 
-template <class T>
-bool Vector<T>::operator<=(const Vector<T> &other) const {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator<=(const Vector<T, Allocator, GrowthPolicy> &other) const {
     return !(other < *this);
 }
 
-template <class T>
-bool Vector<T>::operator>=(const Vector<T> &other) const {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator>=(const Vector<T, Allocator, GrowthPolicy> &other) const {
     return !(*this < other);
 }
 
-template <class T>
-bool Vector<T>::operator!=(const Vector<T> &other) const {
+template <class T, class Allocator, class GrowthPolicy>
+bool Vector<T, Allocator, GrowthPolicy>::operator!=(const Vector<T, Allocator, GrowthPolicy> &other) const {
     return !(*this == other);
 }
 
-template <class T>
-void Vector<T>::Fill(const size_t start, const size_t end, const T &value) {
-    for (size_t i = start; i < end; ++i) {
-        buffer_[i] = value;
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Fill(const size_t start, const size_t end, const T &value) {
+    if (start < end) {
+        vector_detail::Fill(buffer_ + start, end - start, value);
     }
 }
 
-template <class T>
-size_t Vector<T>::IncreaseCapacity() const {
-    return (capacity_ == 0) ? 1 : capacity_ * kIncreaseFactor;
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Find(const T &value) const {
+    return vector_detail::Find(buffer_, size_, value);
 }
 
-template <class T>
-void Vector<T>::BufferReallocation(const size_t new_capacity) {
-    T *new_buffer = (new_capacity == 0) ? nullptr : new T[new_capacity];
-    size_ = std::min(size_, new_capacity);
-    Copy(new_buffer, buffer_, size_);
-    delete[] buffer_;
-    capacity_ = new_capacity;
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::Count(const T &value) const {
+    return vector_detail::Count(buffer_, size_, value);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+std::pair<T, T> Vector<T, Allocator, GrowthPolicy>::MinMax() const {
+    if (size_ == 0) {
+        throw VectorOutOfRange{};
+    }
+    std::pair<T, T> result(buffer_[0], buffer_[0]);
+    vector_detail::MinMax(buffer_, size_, &result.first, &result.second);
+    return result;
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::IncreaseCapacity() const {
+    return GrownCapacity(capacity_ + 1);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+size_t Vector<T, Allocator, GrowthPolicy>::GrownCapacity(const size_t required) const {
+    return GrowthPolicy::NextCapacity(capacity_, required, sizeof(T));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::BufferReallocation(const size_t new_capacity) {
+    if constexpr (kReallocates) {
+        if (buffer_ != nullptr && new_capacity != 0) {
+            size_t kept = std::min(size_, new_capacity);
+            vector_detail::Destroy(buffer_ + kept, size_ - kept);
+            size_ = kept;
+            buffer_ = allocator_.reallocate(buffer_, capacity_, new_capacity);
+            capacity_ = new_capacity;
+            return;
+        }
+    }
+    T *new_buffer = Allocate(new_capacity);
+    size_t kept = std::min(size_, new_capacity);
+    try {
+        vector_detail::Relocate(new_buffer, buffer_, kept);
+    } catch (...) {
+        Deallocate(new_buffer, new_capacity);
+        throw;
+    }
+    vector_detail::Destroy(buffer_ + kept, size_ - kept);
+    Deallocate(buffer_, capacity_);
     buffer_ = new_buffer;
+    size_ = kept;
+    capacity_ = new_capacity;
 }
 
 #endif  // VECTOR_VECTOR_H